@@ -1204,7 +1204,13 @@ next_ware_check:
 							buf.printf( translator::translate("Factory chain extended\nfor %s near\n%s built with\n%i factories."), translator::translate(unlinked_consumer->get_name()), stadt_name, nr );
 							welt->get_message()->add_message(buf, unlinked_consumer->get_pos().get_2d(), message_t::industry, CITY_KI, unlinked_consumer->get_desc()->get_building()->get_tile(0)->get_background(0, 0, 0));
 						}
-						minimap_t::get_instance()->calc_map();
+						// the new factories are somewhere around the consumer and its suppliers
+						koord lo = unlinked_consumer->get_pos().get_2d(), hi = lo;
+						FOR(vector_tpl<koord>, const& supplier, unlinked_consumer->get_suppliers()) {
+							lo.clip_max( supplier );
+							hi.clip_min( supplier );
+						}
+						minimap_t::get_instance()->invalidate_map_area( lo - koord(8,8), hi + koord(8,8) );
 						return nr;
 					}
 				}
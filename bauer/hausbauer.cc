@@ -533,6 +533,9 @@ void hausbauer_t::remove( player_t *player, const gebaeude_t *gb, bool map_gener
 			}
 		}
 	}
+
+	// update minimap
+	minimap_t::get_instance()->invalidate_map_area( pos.get_2d(), pos.get_2d() + size - koord(1,1) );
 }
 
 
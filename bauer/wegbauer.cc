@@ -1471,11 +1471,20 @@ void get_mini_maxi( const vector_tpl<koord3d> &ziel, koord3d &mini, koord3d &max
 }
 
 
+/* ziel can be a long list (all tiles near a station for the ai),
+ * so test the cuboid containing it first
+ */
+static inline bool is_target( const koord3d &pos, const vector_tpl<koord3d> &ziel, const koord3d &mini, const koord3d &maxi )
+{
+	return  mini.x <= pos.x  &&  pos.x <= maxi.x  &&  mini.y <= pos.y  &&  pos.y <= maxi.y  &&  mini.z <= pos.z  &&  pos.z <= maxi.z  &&  ziel.is_contained(pos);
+}
+
+
 /* this routine uses A* to calculate the best route
  * beware: change the cost and you will mess up the system!
  * (but you can try, look at simuconf.tab)
  */
-sint32 way_builder_t::intern_calc_route(const vector_tpl<koord3d> &start, const vector_tpl<koord3d> &ziel)
+sint32 way_builder_t::intern_calc_route(const vector_tpl<koord3d> &start, const vector_tpl<koord3d> &ziel, uint32 max_cost)
 {
 	// we clear it here probably twice: does not hurt ...
 	route.clear();
@@ -1502,6 +1511,8 @@ sint32 way_builder_t::intern_calc_route(const vector_tpl<koord3d> &start, const
 
 	static binary_heap_tpl <route_t::ANode *> queue;
 
+	const uint32 max_g = max_cost < maximum ? max_cost : maximum;
+
 	// get exclusively a tile list
 	route_t::ANode *nodes;
 	uint8 ni = route_t::GET_NODES(&nodes);
@@ -1574,7 +1585,7 @@ DBG_DEBUG("insert to close","(%i,%i,%i)  f=%i",gr->get_pos().x,gr->get_pos().y,g
 #endif
 
 		// already there
-		if(  ziel.is_contained(gr_pos)  ||  tmp->g>maximum) {
+		if(  is_target(gr_pos, ziel, mini, maxi)  ||  tmp->g>max_g) {
 			// we added a target to the closed list: we are finished
 			break;
 		}
@@ -1747,7 +1758,7 @@ DBG_DEBUG("way_builder_t::intern_calc_route()","steps=%i  (max %i) in route, ope
 	long cost = -1;
 //DBG_DEBUG("reached","%i,%i",tmp->pos.x,tmp->pos.y);
 	// target reached?
-	if(  !ziel.is_contained(gr->get_pos())  ||  tmp->parent==NULL  ||  tmp->g > maximum  ) {
+	if(  !is_target(gr->get_pos(), ziel, mini, maxi)  ||  tmp->parent==NULL  ||  tmp->g > max_g  ) {
 	}
 	else if(  step>=route_t::MAX_STEP  ) {
 		dbg->warning("way_builder_t::intern_calc_route()","Too many steps (%i>=max %i) in route (too long/complex)",step,route_t::MAX_STEP);
@@ -2073,7 +2084,9 @@ uint32 ms = dr_time();
 		swap(route, route2);
 		swap(terraform_index, terraform_index2);
 		route_reversed = false;
-		long cost = intern_calc_route(ziel, start);
+		// only a cheaper (or equal) route would replace the first one,
+		// so do not search further; this saves most time, when there is no way back
+		long cost = intern_calc_route(ziel, start, cost2);
 		INT_CHECK("wegbauer 1165");
 
 		// the cheaper will survive ...
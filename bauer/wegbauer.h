@@ -185,7 +185,12 @@ private:
 	// may modify next_gr array!
 	void check_for_bridge(const grund_t* parent_from, const grund_t* from, const vector_tpl<koord3d> &ziel);
 
-	sint32 intern_calc_route(const vector_tpl<koord3d> &start, const vector_tpl<koord3d> &ziel);
+	/**
+	 * A* search from start to one of the ziel tiles.
+	 * @param max_cost routes more expensive than this are not searched (besides maximum)
+	 * @return the cost of the route or -1 if no route was found
+	 */
+	sint32 intern_calc_route(const vector_tpl<koord3d> &start, const vector_tpl<koord3d> &ziel, uint32 max_cost = 0xFFFFFFFFu);
 	void intern_calc_straight_route(const koord3d start, const koord3d ziel);
 
 	// runways need to meet some special conditions enforced here
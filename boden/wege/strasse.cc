@@ -7,6 +7,7 @@
 
 #include "strasse.h"
 #include "../../simworld.h"
+#include "../grund.h"
 #include "../../obj/bruecke.h"
 #include "../../obj/tunnel.h"
 #include "../../dataobj/loadsave.h"
@@ -56,6 +57,29 @@ void strasse_t::set_gehweg(bool janein)
 
 
 
+const minivec_tpl<vehicle_base_t *> &strasse_t::get_road_users(const grund_t *gr)
+{
+	static const minivec_tpl<vehicle_base_t *> no_road_users;
+	if(  gr  ) {
+		if(  const strasse_t *str = (const strasse_t *)gr->get_weg(road_wt)  ) {
+			return str->get_road_users();
+		}
+	}
+	return no_road_users;
+}
+
+
+void strasse_t::remove_road_user(const obj_t *v)
+{
+	for(  uint8 i=0;  i<road_users.get_count();  i++  ) {
+		if(  road_users[i] == v  ) {
+			road_users.remove_at(i);
+			return;
+		}
+	}
+}
+
+
 strasse_t::strasse_t(loadsave_t *file) : weg_t(road_wt)
 {
 	rdwr(file);
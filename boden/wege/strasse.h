@@ -11,6 +11,8 @@
 //#include "../../tpl/minivec_tpl.h"
 
 class fabrik_t;
+class grund_t;
+class vehicle_base_t;
 //class gebaeude_t;
 
 /**
@@ -33,6 +35,12 @@ private:
 	*/
 	uint8 ribi_mask_oneway:4;
 
+	/**
+	* Road vehicles, private cars and animals on this tile in the order of the object list.
+	* Maintained by objlist_t, so the traffic does not need to search all objects of a tile.
+	*/
+	minivec_tpl<vehicle_base_t *> road_users;
+
 public:
 	static const way_desc_t *default_strasse;
 
@@ -68,6 +76,17 @@ public:
 
 	void rotate90() OVERRIDE;
 
+	/// road vehicles, private cars and animals on this tile, pedestrians are not included
+	const minivec_tpl<vehicle_base_t *> &get_road_users() const { return road_users; }
+
+	/// @return the road users on the road of this ground, an empty list if there is no road
+	static const minivec_tpl<vehicle_base_t *> &get_road_users(const grund_t *gr);
+
+	// only used by objlist_t
+	void insert_road_user(uint8 pos, vehicle_base_t *v) { road_users.insert_at(pos, v); }
+	void remove_road_user(const obj_t *v);
+	void clear_road_users() { road_users.clear(); }
+
 	image_id get_front_image() const OVERRIDE
 	{
 		if (show_masked_ribi && overtaking_mode <= oneway_mode) {
@@ -494,6 +494,12 @@ public:
 	*/
 	int get_statistics(int type) const { return statistics[WAY_STAT_LAST_MONTH][type]; }
 
+	/// @return the statistics value of the current month so far
+	int get_current_statistics(int type) const { return statistics[WAY_STAT_THIS_MONTH][type]; }
+
+	/// @return the travel time of the given month (WAY_STAT_THIS_MONTH or WAY_STAT_LAST_MONTH)
+	uint32 get_travel_time(int month, int type) const { return travel_times[month][type]; }
+
 	bool is_disused() const { return statistics[WAY_STAT_LAST_MONTH][WAY_STAT_CONVOIS] == 0 && statistics[WAY_STAT_THIS_MONTH][WAY_STAT_CONVOIS] == 0; }
 
 	/**
@@ -374,6 +374,7 @@ enum convoy_detail_e
 	cd_starting_force   = 0x10,
 	cd_continuous_power = 0x20,
 	cd_braking_force    = 0x40,
+	cd_force_table      = 0x80,
 };
 
 class lazy_convoy_t /*abstract*/ : public convoy_t
@@ -396,7 +397,7 @@ public:
 	// vehicle_summary becomes invalid, when the vehicle list or any vehicle's vehicle_desc_t changes.
 	inline void invalidate_vehicle_summary()
 	{
-		is_valid &= ~(cd_vehicle_summary|cd_adverse_summary|cd_weight_summary|cd_starting_force|cd_continuous_power|cd_braking_force);
+		is_valid &= ~(cd_vehicle_summary|cd_adverse_summary|cd_weight_summary|cd_starting_force|cd_continuous_power|cd_braking_force|cd_force_table);
 	}
 
 	// vehicle_summary is valid if (is_valid & cd_vehicle_summary != 0)
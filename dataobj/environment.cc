@@ -63,6 +63,10 @@ sint32 env_t::network_frames_per_step = 4;
 uint32 env_t::server_sync_steps_between_checks = 24;
 bool env_t::pause_server_no_clients = false;
 bool env_t::server_runs_background_tasks_when_paused = false;
+bool env_t::server_hot_join = false;
+uint32 env_t::server_snapshot_reuse_time = 60;
+uint32 env_t::server_state_hash_interval = 0;
+std::string env_t::server_command_log;
 
 std::string env_t::nickname = "";
 
@@ -153,6 +157,9 @@ bool env_t::cities_ignore_height = false;
 bool env_t::second_open_closes_win;
 bool env_t::remember_window_positions;
 uint8 env_t::num_threads;
+uint32 env_t::image_cache_budget;
+uint16 env_t::private_car_flow_visible_radius;
+bool env_t::script_profiling;
 bool env_t::draw_earth_border;
 bool env_t::draw_outside_tile;
 
@@ -277,6 +284,11 @@ void env_t::init()
 	num_threads = 1;
 #endif
 
+	image_cache_budget = 512;
+
+	private_car_flow_visible_radius = 48;
+	script_profiling = false;
+
 	sound_distance_scaling = 10;
 
 	show_tooltips = true;
@@ -140,6 +140,18 @@ public:
 	/// The server will run the path explorer and private car route finder when paused if this is set.
 	static bool server_runs_background_tasks_when_paused;
 
+	/// if true, only a joining client loads the game, the other clients keep playing
+	static bool server_hot_join;
+
+	/// seconds a hot join snapshot is sent to further joining clients before a new one is saved
+	static uint32 server_snapshot_reuse_time;
+
+	/// sync steps between hashes of the world state to locate desyncs, zero for off (see state_hash_t)
+	static uint32 server_state_hash_interval;
+
+	/// server records its world commands to <name>.rec for replays, empty for off (see command_log_t)
+	static std::string server_command_log;
+
 	/// nickname of player
 	static std::string nickname;
 
@@ -411,6 +423,15 @@ public:
 	/// number of threads to use (if MULTI_THREAD defined)
 	static uint8 num_threads;
 
+	/// maximum memory in MB for cached player colour images (0 = unlimited)
+	static uint32 image_cache_budget;
+
+	/// with private car flows: distance in tiles from the view centre within which trips are still driven by cars
+	static uint16 private_car_flow_visible_radius;
+
+	/// if true, scripts are profiled and the profile is written to script.log every month
+	static bool script_profiling;
+
 	/// false to quit the programs
 	static bool quit_simutrans;
 
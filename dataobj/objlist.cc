@@ -28,6 +28,8 @@
 #include "../obj/roadsign.h"
 #include "../obj/groundobj.h"
 
+#include "../boden/wege/strasse.h"
+
 #include "../simtypes.h"
 #include "../simdepot.h"
 #include "../simsignalbox.h"
@@ -356,6 +358,48 @@ bool objlist_t::intern_add_moving(obj_t* new_obj)
 }
 
 
+// road vehicles, private cars and animals walking on roads, but not pedestrians
+static inline bool is_road_user(const obj_t *obj)
+{
+	switch(  obj->get_typ()  ) {
+		case obj_t::road_user:
+		case obj_t::road_vehicle:
+			return true;
+		case obj_t::movingobj:
+			return static_cast<const movingobj_t *>(obj)->get_waytype() == road_wt;
+		default:
+			return false;
+	}
+}
+
+
+strasse_t *objlist_t::get_road() const
+{
+	// the ways are the first objects, a road can follow a rail on crossings
+	for(  uint8 i=0;  capacity>1  &&  i<top  &&  i<2;  i++  ) {
+		weg_t *w = obj_cast<weg_t>(obj.some[i]);
+		if(  w  &&  w->get_waytype() == road_wt  ) {
+			return static_cast<strasse_t *>(w);
+		}
+	}
+	return NULL;
+}
+
+
+// the road users are kept in the same order as here, so searching them gives the same result as searching this list
+void objlist_t::update_road_users()
+{
+	if(  strasse_t *str = get_road()  ) {
+		str->clear_road_users();
+		for(  uint8 i=0;  i<top;  i++  ) {
+			if(  obj.some[i]->is_moving()  &&  is_road_user(obj.some[i])  ) {
+				str->insert_road_user(str->get_road_users().get_count(), (vehicle_base_t *)obj.some[i]);
+			}
+		}
+	}
+}
+
+
 /**
  * @returns true if tree1 must be sorted before tree2 (tree1 stands behind tree2)
  */
@@ -404,7 +448,13 @@ bool objlist_t::add(obj_t* new_obj)
 
 	// vehicles need a special order
 	if(pri==moving_obj_pri) {
-		return intern_add_moving(new_obj);
+		if(  !intern_add_moving(new_obj)  ) {
+			return false;
+		}
+		if(  is_road_user(new_obj)  ) {
+			update_road_users();
+		}
+		return true;
 	}
 
 	// roads must be first!
@@ -413,6 +463,10 @@ bool objlist_t::add(obj_t* new_obj)
 		weg_t const* const w   = obj_cast<weg_t>(obj.some[0]);
 		uint8        const pos = w  &&  w->get_waytype() < static_cast<weg_t*>(new_obj)->get_waytype() ? 1 : 0;
 		intern_insert_at(new_obj, pos);
+		if(  static_cast<weg_t*>(new_obj)->get_waytype() == road_wt  ) {
+			// the vehicles may have been moved here before the road (grund_t replaced)
+			update_road_users();
+		}
 		return true;
 	}
 
@@ -478,6 +532,11 @@ obj_t *objlist_t::remove_last()
 			top --;
 			last_obj = obj.some[top];
 			obj.some[top] = NULL;
+			if(  last_obj->is_moving()  ) {
+				if(  strasse_t *str = get_road()  ) {
+					str->remove_road_user(last_obj);
+				}
+			}
 		}
 	}
 	return last_obj;
@@ -503,6 +562,11 @@ bool objlist_t::remove(const obj_t* remove_obj)
 	for(  uint8 i=0;  i<top;  i++  ) {
 		if(  obj.some[i] == remove_obj  ) {
 			// found it!
+			if(  remove_obj->is_moving()  ) {
+				if(  strasse_t *str = get_road()  ) {
+					str->remove_road_user(remove_obj);
+				}
+			}
 			top--;
 			while(  i < top  ) {
 				obj.some[i] = obj.some[i+1];
@@ -549,8 +613,12 @@ bool objlist_t::loesche_alle(player_t *player, uint8 offset)
 	bool ok=false;
 
 	if(capacity>1) {
+		strasse_t *str = get_road();
 		while(  top>offset  ) {
 			top --;
+			if(  str  &&  obj.some[top]->is_moving()  ) {
+				str->remove_road_user(obj.some[top]);
+			}
 			local_delete_object(obj.some[top], player);
 			obj.some[top] = NULL;
 			ok = true;
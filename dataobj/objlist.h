@@ -10,6 +10,7 @@
 #include "../simtypes.h"
 #include "../obj/simobj.h"
 
+class strasse_t;
 
 class objlist_t {
 private:
@@ -41,6 +42,12 @@ private:
 	// this will automatically give the right order for citycars and the like ...
 	bool intern_add_moving(obj_t* new_obj);
 
+	/// @return the road of this tile or NULL
+	strasse_t *get_road() const;
+
+	/// fills the list of road users of the road in the order of this list
+	void update_road_users();
+
 	objlist_t(objlist_t const&);
 	objlist_t& operator=(objlist_t const&);
 public:
@@ -12,7 +12,7 @@
 #include "../halthandle_t.h"
 
 #include "../tpl/minivec_tpl.h"
-#include "../tpl/koordhashtable_tpl.h"
+#include "../tpl/koordmap_tpl.h"
 
 #include "../simskin.h"
 #include "../display/simimg.h"
@@ -445,6 +445,6 @@ public:
     uint32 get_average_seconds() const;
 };
 
-typedef koordhashtable_tpl<departure_point_t, times_history_data_t, N_BAGS_SMALL> times_history_map;
+typedef koordmap_tpl<departure_point_t, times_history_data_t> times_history_map;
 
 #endif
@@ -1894,6 +1894,10 @@ void settings_t::rdwr(loadsave_t *file)
 			file->rdwr_bool(do_not_record_private_car_routes_to_distant_non_consumer_industries);
 			file->rdwr_bool(do_not_record_private_car_routes_to_city_buildings);
 		}
+
+		if(  file->is_version_ex_atleast(14, 42)  ) {
+			file->rdwr_byte(private_car_flows);
+		}
 		// otherwise the default values of the last one will be used
 	}
 
@@ -2012,6 +2016,9 @@ void settings_t::parse_simuconf( tabfile_t& simuconf, sint16& disp_width, sint16
 	env_t::fps = clamp( (uint32)contents.get_int( "frames_per_second", env_t::fps ), env_t::min_fps, env_t::max_fps );
 	env_t::ff_fps = clamp( (uint32)contents.get_int( "fast_forward_frames_per_second", env_t::ff_fps ), env_t::min_fps, env_t::max_fps );
 	env_t::num_threads = clamp( contents.get_int( "threads", env_t::num_threads ), 1, MAX_THREADS );
+	env_t::image_cache_budget = contents.get_int( "image_cache_budget", env_t::image_cache_budget );
+	env_t::private_car_flow_visible_radius = contents.get_int( "private_car_flow_visible_radius", env_t::private_car_flow_visible_radius );
+	env_t::script_profiling = contents.get_int( "script_profiling", env_t::script_profiling ) != 0;
 	env_t::simple_drawing_default = contents.get_int( "simple_drawing_tile_size", env_t::simple_drawing_default );
 	env_t::simple_drawing_fast_forward = contents.get_int( "simple_drawing_fast_forward", env_t::simple_drawing_fast_forward );
 	env_t::visualize_schedule = contents.get_int( "visualize_schedule", env_t::visualize_schedule ) != 0;
@@ -2063,6 +2070,10 @@ void settings_t::parse_simuconf( tabfile_t& simuconf, sint16& disp_width, sint16
 	env_t::server_save_game_on_quit         =        contents.get_int( "server_save_game_on_quit",        env_t::server_save_game_on_quit ) != 0;
 	env_t::reload_and_save_on_quit          =        contents.get_int( "reload_and_save_on_quit",         env_t::reload_and_save_on_quit )  != 0;
 	env_t::server_runs_background_tasks_when_paused = contents.get_int("server_runs_background_tasks_when_paused", env_t::server_runs_background_tasks_when_paused);
+	env_t::server_hot_join                  =        contents.get_int( "server_hot_join",                 env_t::server_hot_join ) != 0;
+	env_t::server_snapshot_reuse_time       =        contents.get_int( "server_snapshot_reuse_time",      env_t::server_snapshot_reuse_time );
+	env_t::server_state_hash_interval       =        contents.get_int( "server_state_hash_interval",      env_t::server_state_hash_interval );
+	env_t::server_command_log               = ltrim( contents.get_string( "server_command_log",           env_t::server_command_log.c_str() ) );
 
 	env_t::server_announce = contents.get_int( "announce_server", env_t::server_announce );
 	if( !env_t::server ) {
@@ -2804,6 +2815,7 @@ void settings_t::parse_simuconf( tabfile_t& simuconf, sint16& disp_width, sint16
 	private_car_route_to_industry_visitor_demand_threshold = contents.get_int("private_car_route_to_industry_visitor_demand_threshold", private_car_route_to_industry_visitor_demand_threshold);
 	do_not_record_private_car_routes_to_distant_non_consumer_industries = contents.get_int("do_not_record_private_car_routes_to_distant_non_consumer_industries", do_not_record_private_car_routes_to_distant_non_consumer_industries);
 	do_not_record_private_car_routes_to_city_buildings = contents.get_int("do_not_record_private_car_routes_to_city_buildings", do_not_record_private_car_routes_to_city_buildings);
+	private_car_flows = contents.get_int("private_car_flows", private_car_flows);
 
 	uint32 max_routes_to_process_in_a_step = contents.get_int("max_routes_to_process_in_a_step", 0);
 	const uint32 old_max_route_tiles_extrapolated = max_routes_to_process_in_a_step * 1024;
@@ -372,6 +372,17 @@ private:
 	bool do_not_record_private_car_routes_to_distant_non_consumer_industries = true;
 	bool do_not_record_private_car_routes_to_city_buildings = true;
 
+	/**
+	* How private car trips are simulated:
+	* 0 = every trip is driven by a private car
+	* 1 = trips are routed as flows over the private car routes,
+	*     private cars are only created near the view
+	* 2 = every trip is driven by a private car and the flows are
+	*     calculated alongside for comparison
+	* @see private_car_flow_t
+	*/
+	uint8 private_car_flows = 0;
+
 	/**
 	* This modifies the base journey time tolerance for passenger
 	* trips to allow more fine grained control of the journey time
@@ -1302,6 +1313,8 @@ public:
 	void set_do_not_record_private_car_routes_to_distant_non_consumer_industries(bool value) { do_not_record_private_car_routes_to_distant_non_consumer_industries = value; }
 	bool get_do_not_record_private_car_routes_to_city_buildings() const { return do_not_record_private_car_routes_to_city_buildings; }
 	void set_do_not_record_private_car_routes_to_city_buildings(bool value) { do_not_record_private_car_routes_to_city_buildings = value; }
+
+	uint8 get_private_car_flows() const { return private_car_flows; }
 };
 
 #endif
@@ -24,13 +24,39 @@
 #define skip_reading_pixels_if_no_graphics goto adjust_image
 #endif
 
+// size of the largest image header (version 0)
+#define IMAGE_HEADER_SIZE (12)
+
+/*
+ * Without graphics only the header is needed: the image keeps its single pixel
+ * and only remembers whether it is empty. Then all non-empty images are identical
+ * and end up as one shared image_t in the duplicate check below.
+ */
+static inline void alloc_image_data(image_t *desc, size_t len)
+{
+#if COLOUR_DEPTH != 0
+	desc->alloc(len);
+#else
+	desc->len = len > 0 ? 4 : 0;
+#endif
+}
+
+
 obj_desc_t *image_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 {
-	ALLOCA(char, desc_buf, node.size);
 	image_t* desc=NULL;
 
 	// Read data
+#if COLOUR_DEPTH != 0
+	ALLOCA(char, desc_buf, node.size);
 	fread(desc_buf, node.size, 1, fp);
+#else
+	// do not even read the pixels
+	char desc_buf[IMAGE_HEADER_SIZE];
+	const uint32 header_size = min( node.size, (uint32)IMAGE_HEADER_SIZE );
+	fread(desc_buf, header_size, 1, fp);
+	fseek(fp, node.size - header_size, SEEK_CUR);
+#endif
 	char * p = desc_buf+6;
 
 	// always zero in old version, since length was always less than 65535
@@ -50,7 +76,7 @@ obj_desc_t *image_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 		desc->w = decode_uint8(p);
 		desc->y = decode_uint8(p);
 		desc->h = decode_uint8(p);
-		desc->alloc(decode_uint32(p)); // len
+		alloc_image_data(desc, decode_uint32(p)); // len
 		desc->imageid = IMG_EMPTY;
 		p += 2; // dummys
 		desc->zoomable = decode_uint8(p);
@@ -78,7 +104,7 @@ obj_desc_t *image_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 		desc->w = decode_uint8(p);
 		desc->h = decode_uint8(p);
 		p++; // skip version information
-		desc->alloc(decode_uint16(p)); // len
+		alloc_image_data(desc, decode_uint16(p)); // len
 		desc->zoomable = decode_uint8(p);
 		desc->imageid = IMG_EMPTY;
 
@@ -96,7 +122,7 @@ obj_desc_t *image_reader_t::read_node(FILE *fp, obj_node_info_t &node)
 		desc->w = decode_sint16(p);
 		p++; // skip version information
 		desc->h = decode_sint16(p);
-		desc->alloc((node.size - 10) / 2); // len
+		alloc_image_data(desc, (node.size - 10) / 2); // len
 		desc->zoomable = decode_uint8(p);
 		desc->imageid = IMG_EMPTY;
 
@@ -12,6 +12,7 @@
 #include "../../sys/simsys.h"
 #include "../../simtypes.h"
 #include "../../simloadingscreen.h"
+#include "../../simmem.h"
 
 #include "../skin_desc.h"   // just for the logo
 #include "../ground_desc.h" // for the error message!
@@ -34,6 +35,14 @@
 
 #include "obj_reader.h"
 
+#ifdef MULTI_THREAD
+#include "../../utils/simthread.h"
+// parsing from memory needs fmemopen()
+#if !defined(_WIN32)
+#define STAGE_PAK_FILES
+#endif
+#endif
+
 
 obj_reader_t::obj_map*                                        obj_reader_t::obj_reader;
 inthashtable_tpl<obj_type, stringhashtable_tpl<obj_desc_t*, N_BAGS_LARGE>, N_BAGS_LARGE> obj_reader_t::loaded;
@@ -147,14 +156,24 @@ DBG_MESSAGE("obj_reader_t::load()","big logo %p", skinverwaltung_t::biglogosymbo
 
 DBG_MESSAGE("obj_reader_t::load()", "reading from '%s'", name.c_str());
 
-		uint n = 0;
-		FORX(searchfolder_t, const& i, find, ++n) {
-			read_file(i);
-			if ((n & step) == 0 && drawing) {
-				ls.set_progress(n);
+		const uint32 start_time = dr_time();
+#ifdef STAGE_PAK_FILES
+		if(  env_t::num_threads > 1  ) {
+			read_files_staged(find, ls, step, drawing);
+		}
+		else
+#endif
+		{
+			uint n = 0;
+			FORX(searchfolder_t, const& i, find, ++n) {
+				read_file(i);
+				if ((n & step) == 0 && drawing) {
+					ls.set_progress(n);
+				}
 			}
 		}
 		ls.set_progress(max);
+		dbg->message("obj_reader_t::load()", "read %i files from '%s' in %u ms", max, name.c_str(), dr_time() - start_time);
 
 		return find.begin()!=find.end();
 	}
@@ -168,45 +187,202 @@ void obj_reader_t::read_file(const char *name)
 	DBG_DEBUG("obj_reader_t::read_file()", "filename='%s'", name);
 
 	if (FILE* const fp = dr_fopen(name, "rb")) {
-		sint32 n = 0;
+		read_stream(fp, name);
+		fclose(fp);
+	}
+	else {
+		dbg->error("obj_reader_t::read_file()", "reading '%s' failed!", name);
+	}
+}
+
+
+void obj_reader_t::read_stream(FILE *fp, const char *name)
+{
+	sint32 n = 0;
 
-		// This is the normal header reading code
-		int c;
-		do {
-			c = fgetc(fp);
-			n ++;
-		} while(!feof(fp) && c != 0x1a);
+	// This is the normal header reading code
+	int c;
+	do {
+		c = fgetc(fp);
+		n ++;
+	} while(!feof(fp) && c != 0x1a);
+
+	if(feof(fp)) {
+		dbg->error("obj_reader_t::read_file()", "unexpected end of file after %d bytes while reading '%s'!",n, name);
+	}
+	else {
+//		DBG_DEBUG("obj_reader_t::read_file()", "skipped %d header bytes", n);
+	}
 
-		if(feof(fp)) {
-			dbg->error("obj_reader_t::read_file()", "unexpected end of file after %d bytes while reading '%s'!",n, name);
+	// Compiled Version
+	uint32 version = 0;
+	char dummy[4], *p;
+	p = dummy;
+
+	n = fread(dummy, 4, 1, fp);
+	version = decode_uint32(p);
+
+	DBG_DEBUG("obj_reader_t::read_file()", "read %d blocks, file version is %x", n, version);
+
+	if(version <= COMPILER_VERSION_CODE) {
+		obj_desc_t *data = NULL;
+		read_nodes(fp, data, 0, version );
+	}
+	else {
+		DBG_DEBUG("obj_reader_t::read_file()","version of '%s' is too old, %d instead of %d", name, version, COMPILER_VERSION_CODE );
+	}
+}
+
+
+#ifdef STAGE_PAK_FILES
+/*
+ * Staged loading: several threads read the pak files into memory ahead of the
+ * parser. Parsing and registering stays single threaded and in file order, since
+ * image ids, duplicate image detection and xref resolution depend on that order.
+ */
+
+// at most this many files are kept in memory ahead of the parser
+#define PAK_STAGING_WINDOW (64)
+
+struct pak_staging_t
+{
+	const char *name;
+	char *data;     ///< file content, NULL if it could not be read
+	size_t size;
+	uint32 read_ms;
+	bool ready;
+};
+
+static pak_staging_t *staging = NULL;
+static uint32 staging_count = 0;
+static uint32 staging_next = 0;     ///< next file to be read by a staging thread
+static uint32 staging_consumed = 0; ///< file currently parsed
+static pthread_mutex_t staging_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t staging_cond = PTHREAD_COND_INITIALIZER;
+
+
+static void stage_pak_file(pak_staging_t &file)
+{
+	const uint32 start_time = dr_time();
+	file.data = NULL;
+	file.size = 0;
+	if(  FILE *const fp = dr_fopen(file.name, "rb")  ) {
+		if(  fseek(fp, 0, SEEK_END) == 0  ) {
+			const long size = ftell(fp);
+			if(  size > 0  ) {
+				rewind(fp);
+				file.data = MALLOCN(char, size);
+				if(  fread(file.data, size, 1, fp) == 1  ) {
+					file.size = size;
+				}
+				else {
+					free(file.data);
+					file.data = NULL;
+				}
+			}
 		}
-		else {
-//			DBG_DEBUG("obj_reader_t::read_file()", "skipped %d header bytes", n);
+		fclose(fp);
+	}
+	file.read_ms = dr_time() - start_time;
+}
+
+
+static void *stage_pak_files_thread(void *)
+{
+	while(  true  ) {
+		pthread_mutex_lock(&staging_mutex);
+		while(  staging_next < staging_count  &&  staging_next >= staging_consumed + PAK_STAGING_WINDOW  ) {
+			pthread_cond_wait(&staging_cond, &staging_mutex);
 		}
+		if(  staging_next >= staging_count  ) {
+			pthread_mutex_unlock(&staging_mutex);
+			return NULL;
+		}
+		pak_staging_t &file = staging[staging_next++];
+		pthread_mutex_unlock(&staging_mutex);
+
+		stage_pak_file(file);
+
+		pthread_mutex_lock(&staging_mutex);
+		file.ready = true;
+		pthread_cond_broadcast(&staging_cond);
+		pthread_mutex_unlock(&staging_mutex);
+	}
+}
 
-		// Compiled Version
-		uint32 version = 0;
-		char dummy[4], *p;
-		p = dummy;
 
-		n = fread(dummy, 4, 1, fp);
-		version = decode_uint32(p);
+void obj_reader_t::read_files_staged(const searchfolder_t &find, loadingscreen_t &ls, uint32 step, bool drawing)
+{
+	staging_count = (uint32)(find.end() - find.begin());
+	if(  staging_count == 0  ) {
+		return;
+	}
+	staging = new pak_staging_t[staging_count];
+	uint32 n = 0;
+	FORX(searchfolder_t, const& i, find, ++n) {
+		staging[n].name = i;
+		staging[n].data = NULL;
+		staging[n].ready = false;
+	}
+	staging_next = staging_consumed = 0;
+
+	// the main thread is busy parsing
+	const int num_threads = max( 1, env_t::num_threads - 1 );
+	pthread_t thread[MAX_THREADS];
+	int spawned = 0;
+	for(  ;  spawned < num_threads;  spawned++  ) {
+		if(  pthread_create(&thread[spawned], NULL, stage_pak_files_thread, NULL)  ) {
+			dbg->warning("obj_reader_t::read_files_staged()", "cannot create staging thread #%i", spawned);
+			break;
+		}
+	}
 
-		DBG_DEBUG("obj_reader_t::read_file()", "read %d blocks, file version is %x", n, version);
+	for(  n = 0;  n < staging_count;  n++  ) {
+		pak_staging_t &file = staging[n];
 
-		if(version <= COMPILER_VERSION_CODE) {
-			obj_desc_t *data = NULL;
-			read_nodes(fp, data, 0, version );
+		pthread_mutex_lock(&staging_mutex);
+		staging_consumed = n;
+		pthread_cond_broadcast(&staging_cond);
+		const bool read_here = spawned == 0  &&  staging_next <= n;
+		if(  read_here  ) {
+			// no staging threads at all
+			staging_next = n + 1;
+		}
+		while(  !read_here  &&  !file.ready  ) {
+			pthread_cond_wait(&staging_cond, &staging_mutex);
+		}
+		pthread_mutex_unlock(&staging_mutex);
+		if(  read_here  ) {
+			stage_pak_file(file);
+		}
+
+		const uint32 start_time = dr_time();
+		DBG_DEBUG("obj_reader_t::read_files_staged()", "filename='%s'", file.name);
+		FILE *fp = file.data ? fmemopen(file.data, file.size, "rb") : NULL;
+		if(  fp  ) {
+			read_stream(fp, file.name);
+			fclose(fp);
 		}
 		else {
-			DBG_DEBUG("obj_reader_t::read_file()","version of '%s' is too old, %d instead of %d", name, version, COMPILER_VERSION_CODE );
+			dbg->error("obj_reader_t::read_file()", "reading '%s' failed!", file.name);
+		}
+		free(file.data);
+		file.data = NULL;
+		dbg->message("obj_reader_t::read_files_staged()", "%s: %u bytes, %u ms reading, %u ms parsing", file.name, (uint32)file.size, file.read_ms, dr_time() - start_time);
+
+		if ((n & step) == 0 && drawing) {
+			ls.set_progress(n);
 		}
-		fclose(fp);
 	}
-	else {
-		dbg->error("obj_reader_t::read_file()", "reading '%s' failed!", name);
+
+	for(  int t = 0;  t < spawned;  t++  ) {
+		pthread_join(thread[t], NULL);
 	}
+	delete [] staging;
+	staging = NULL;
+	staging_count = 0;
 }
+#endif
 
 
 static void read_node_info(obj_node_info_t& node, FILE* const f, uint32 const version)
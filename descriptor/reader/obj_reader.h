@@ -17,6 +17,8 @@
 
 
 class obj_desc_t;
+class searchfolder_t;
+class loadingscreen_t;
 template<class key_t, class value_t, size_t n_bags> class inthashtable_tpl;
 template<class value_t, size_t n_bags> class stringhashtable_tpl;
 template<class key_t, class value_t, size_t n_bags> class ptrhashtable_tpl;
@@ -83,6 +85,12 @@ class obj_reader_t
 	static void read_nodes(FILE* fp, obj_desc_t*& data, int register_nodes,uint32 version);
 	static void skip_nodes(FILE *fp,uint32 version);
 
+	/// reads a complete pak file (from disk or memory), @p name is only used for messages
+	static void read_stream(FILE *fp, const char *name);
+
+	/// reads all files with several threads ahead of the parser (parsing itself stays in order)
+	static void read_files_staged(const searchfolder_t &find, loadingscreen_t &ls, uint32 step, bool drawing);
+
 protected:
 	obj_reader_t() { /* Beware: Cannot register here! */}
 	virtual ~obj_reader_t() {}
@@ -23,6 +23,7 @@
 #include "../unicode.h"
 #include "../simticker.h"
 #include "../utils/simstring.h"
+#include "../tpl/vector_tpl.h"
 #include "simgraph.h"
 #include "../descriptor/vehicle_desc.h"
 #include "../gui/simwin.h"
@@ -338,6 +339,8 @@ struct imd {
 	sint16 base_h; // height
 
 	PIXVAL* base_data; // original image data
+
+	uint32 last_used; // frame stamp of the last draw (for the player colour cache LRU)
 };
 
 // Flags for recoding
@@ -374,6 +377,21 @@ static size_t rezoom_size[MAX_THREADS];
  */
 static struct imd* images = NULL;
 
+/*
+ * Frame counter for the least recently used eviction of player colour images
+ * (incremented in display_flush_buffer())
+ */
+static uint32 image_frame_stamp = 0;
+
+// every this many frames the player colour cache is checked against env_t::image_cache_budget
+#define IMAGE_CACHE_CHECK_INTERVAL (64)
+
+// images drawn within this many frames are never evicted
+#define IMAGE_CACHE_MIN_AGE (8)
+
+// images drawn within this many frames before a zoom change are rezoomed in the background
+#define REZOOM_WORKER_MAX_AGE (256)
+
 /*
  * Number of loaded images
  */
@@ -1106,6 +1124,14 @@ void display_mark_img_dirty(image_id image, scr_coord_val xp, scr_coord_val yp)
  * They are derived from a base image, which may need zooming too
  */
 
+#ifdef MULTI_THREAD
+static void start_rezoom_worker();
+static void stop_rezoom_worker();
+#else
+static inline void start_rezoom_worker() {}
+static inline void stop_rezoom_worker() {}
+#endif
+
 /**
  * Flag all images for rezoom on next draw
  */
@@ -1127,10 +1153,13 @@ void set_zoom_factor(int z)
 {
 	// do not zoom beyond 4 pixels
 	if(  (base_tile_raster_width * zoom_num[z]) / zoom_den[z] > 4  ) {
+		// the background rezoom must not see the zoom factor change under its feet
+		stop_rezoom_worker();
 		zoom_factor = z;
 		tile_raster_width = (base_tile_raster_width * zoom_num[zoom_factor]) / zoom_den[zoom_factor];
 		dbg->message("set_zoom_factor()", "Zoom level now %d (%i/%i)", zoom_factor, zoom_num[zoom_factor], zoom_den[zoom_factor] );
 		rezoom();
+		start_rezoom_worker();
 	}
 }
 
@@ -1877,10 +1906,142 @@ static void rezoom_img(const image_id n)
 }
 
 
+// most recently drawn first
+static bool compare_image_last_used( const image_id a, const image_id b )
+{
+	return images[a].last_used > images[b].last_used;
+}
+
+
+#ifdef MULTI_THREAD
+/*
+ * Background rezoom: after a zoom change the images drawn during the last frames
+ * are very likely visible again. A worker thread rezooms them (most recently
+ * drawn first), so the render threads mostly find ready images instead of
+ * stalling the first frames after the change. Images not yet done are rezoomed
+ * by the render threads as before; rezoom_img() serialises both per image.
+ */
+static pthread_t rezoom_worker_thread;
+static bool rezoom_worker_running = false;
+static volatile bool rezoom_worker_abort = false;
+static vector_tpl<image_id> rezoom_worker_queue;
+
+
+static void *rezoom_worker( void * )
+{
+	for(  uint32 i = 0;  i < rezoom_worker_queue.get_count()  &&  !rezoom_worker_abort;  i++  ) {
+		const image_id n = rezoom_worker_queue[i];
+		if(  (images[n].recode_flags & FLAG_REZOOM)  ) {
+			// no recoding here: that switches the global colour map used by the main thread
+			rezoom_img( n );
+		}
+	}
+	return NULL;
+}
+
+
+static void start_rezoom_worker()
+{
+	stop_rezoom_worker();
+	if(  env_t::num_threads <= 1  ) {
+		return;
+	}
+
+	rezoom_worker_queue.clear();
+	for(  image_id n = 0;  n < anz_images;  n++  ) {
+		if(  (images[n].recode_flags & FLAG_REZOOM)  &&  image_frame_stamp - images[n].last_used < REZOOM_WORKER_MAX_AGE  ) {
+			rezoom_worker_queue.append( n );
+		}
+	}
+	if(  rezoom_worker_queue.empty()  ) {
+		return;
+	}
+	std::sort( rezoom_worker_queue.begin(), rezoom_worker_queue.end(), compare_image_last_used );
+
+	rezoom_worker_abort = false;
+	rezoom_worker_running = pthread_create( &rezoom_worker_thread, NULL, rezoom_worker, NULL ) == 0;
+}
+
+
+/**
+ * Must be called before anything changes the image table or the zoom factor
+ */
+static void stop_rezoom_worker()
+{
+	if(  rezoom_worker_running  ) {
+		rezoom_worker_abort = true;
+		pthread_join( rezoom_worker_thread, NULL );
+		rezoom_worker_running = false;
+	}
+}
+#endif
+
+
+/**
+ * Frees the least recently drawn player colour images until the cache fits
+ * into env_t::image_cache_budget (in MB, 0 = unlimited). Must be called between
+ * frames, i.e. when no render thread is drawing.
+ */
+static void trim_image_cache()
+{
+	if(  env_t::image_cache_budget == 0  ) {
+		return;
+	}
+	const size_t budget = (size_t)env_t::image_cache_budget << 20;
+
+	// the base (player 0) images are always needed, only the player variants are counted
+	size_t total = 0;
+	vector_tpl<image_id> candidates;
+	for(  image_id n = 0;  n < anz_images;  n++  ) {
+		size_t size = 0;
+		for(  uint8 i = 1;  i < MAX_PLAYER_COUNT;  i++  ) {
+			if(  images[n].data[i] != NULL  ) {
+				size += images[n].len * sizeof(PIXVAL);
+			}
+		}
+		if(  size > 0  ) {
+			total += size;
+			if(  image_frame_stamp - images[n].last_used >= IMAGE_CACHE_MIN_AGE  ) {
+				candidates.append( n );
+			}
+		}
+	}
+	if(  total <= budget  ) {
+		return;
+	}
+
+	std::sort( candidates.begin(), candidates.end(), compare_image_last_used );
+	// evict from the end, i.e. oldest first
+	for(  uint32 j = candidates.get_count();  j-- > 0  &&  total > budget;  ) {
+		const image_id n = candidates[j];
+#ifdef MULTI_THREAD
+		// the rezoom worker may free/reallocate the same buffers
+		pthread_mutex_lock( &rezoom_img_mutex[n % env_t::num_threads] );
+		pthread_mutex_lock( &recode_img_mutex );
+#endif
+		for(  uint8 i = 1;  i < MAX_PLAYER_COUNT;  i++  ) {
+			if(  images[n].data[i] != NULL  ) {
+				total -= images[n].len * sizeof(PIXVAL);
+				free( images[n].data[i] );
+				images[n].data[i] = NULL;
+				images[n].player_flags |= (1<<i);
+			}
+		}
+#ifdef MULTI_THREAD
+		pthread_mutex_unlock( &recode_img_mutex );
+		pthread_mutex_unlock( &rezoom_img_mutex[n % env_t::num_threads] );
+#endif
+	}
+	DBG_DEBUG( "trim_image_cache()", "player colour images now use %lu bytes", (unsigned long)total );
+}
+
+
 // force a certain size on a image (for rescaling tool images)
 void display_fit_img_to_width( const image_id n, sint16 new_w )
 {
 	if(  n < anz_images  &&  images[n].base_h > 0  &&  images[n].w != new_w  ) {
+		// the zoom factor is changed temporarily below
+		stop_rezoom_worker();
 		int old_zoom_factor = zoom_factor;
 		for(  int i=0;  i<=MAX_ZOOM_FACTOR;  i++  ) {
 			int zoom_w = (images[n].base_w * zoom_num[i]) / zoom_den[i];
@@ -2093,6 +2254,9 @@ void register_image(image_t *image_in)
 		return;
 	}
 
+	// the table may be reallocated below
+	stop_rezoom_worker();
+
 	if(  anz_images == alloc_images  ) {
 		if(  images==NULL  ) {
 			alloc_images = 510;
@@ -2161,6 +2325,7 @@ void register_image(image_t *image_in)
 
 	// since we do not recode them, we can work with the original data
 	image->base_data = image_in->data;
+	image->last_used = image_frame_stamp - REZOOM_WORKER_MAX_AGE; // not drawn yet
 
 	// now find out, it contains player colors
 
@@ -2171,6 +2336,7 @@ void register_image(image_t *image_in)
 // (mostly needed when changing climate zones)
 void display_free_all_images_above( image_id above )
 {
+	stop_rezoom_worker();
 	while(  above < anz_images  ) {
 		anz_images--;
 		if(  images[anz_images].zoom_data != NULL  ) {
@@ -2545,6 +2711,7 @@ void display_img_aligned( const image_id n, scr_rect area, int align, const int
 void display_img_aux(const image_id n, scr_coord_val xp, scr_coord_val yp, const sint8 player_nr_raw, const int /*daynight*/, const int dirty  CLIP_NUM_DEF)
 {
 	if(  n < anz_images  ) {
+		images[n].last_used = image_frame_stamp;
 		// only use player images if needed
 		const sint8 use_player = (images[n].recode_flags & FLAG_HAS_PLAYER_COLOR) * player_nr_raw;
 		// need to go to nightmode and or re-zoomed?
@@ -2879,6 +3046,7 @@ static void display_color_img_wc(const PIXVAL *sp, scr_coord_val x, scr_coord_va
 void display_color_img(const image_id n, scr_coord_val xp, scr_coord_val yp, sint8 player_nr_raw, const int daynight, const int dirty  CLIP_NUM_DEF)
 {
 	if(  n < anz_images  ) {
+		images[n].last_used = image_frame_stamp;
 		// do we have to use a player nr?
 		const sint8 player_nr = (images[n].recode_flags & FLAG_HAS_PLAYER_COLOR) * player_nr_raw;
 		// first: size check
@@ -3620,6 +3788,7 @@ static void display_img_alpha_wc(scr_coord_val h, const scr_coord_val xp, const
 void display_rezoomed_img_blend(const image_id n, scr_coord_val xp, scr_coord_val yp, const signed char /*player_nr*/, const FLAGGED_PIXVAL color_index, const int /*daynight*/, const int dirty  CLIP_NUM_DEF)
 {
 	if(  n < anz_images  ) {
+		images[n].last_used = image_frame_stamp;
 		// need to go to nightmode and or rezoomed?
 		if(  (images[n].recode_flags & FLAG_REZOOM)  ) {
 			rezoom_img( n );
@@ -3701,6 +3870,7 @@ void display_rezoomed_img_blend(const image_id n, scr_coord_val xp, scr_coord_va
 void display_rezoomed_img_alpha(const image_id n, const image_id alpha_n, const unsigned alpha_flags, scr_coord_val xp, scr_coord_val yp, const signed char /*player_nr*/, const FLAGGED_PIXVAL color_index, const int /*daynight*/, const int dirty  CLIP_NUM_DEF)
 {
 	if(  n < anz_images  &&  alpha_n < anz_images  ) {
+		images[n].last_used = image_frame_stamp;
 		// need to go to nightmode and or rezoomed?
 		if(  (images[n].recode_flags & FLAG_REZOOM)  ) {
 			rezoom_img( n );
@@ -5307,6 +5477,12 @@ void display_flush_buffer()
 	uint32 *tmp = tile_dirty_old;
 	tile_dirty_old = tile_dirty;
 	tile_dirty = tmp; // _old was cleared to 0 in above loops
+
+	// all drawing of this frame is done: safe to evict cached player colour images
+	image_frame_stamp++;
+	if(  (image_frame_stamp % IMAGE_CACHE_CHECK_INTERVAL) == 0  ) {
+		trim_image_cache();
+	}
 }
 
 
@@ -5471,6 +5647,7 @@ bool is_display_init()
  */
 void simgraph_exit()
 {
+	stop_rezoom_worker();
 	dr_os_close();
 
 	free( tile_dirty_old );
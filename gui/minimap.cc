@@ -19,6 +19,7 @@
 #include "../dataobj/translator.h"
 #include "../dataobj/schedule.h"
 #include "../dataobj/powernet.h"
+#include "../dataobj/environment.h"
 
 #include "../boden/wege/schiene.h"
 #include "../obj/leitung2.h"
@@ -44,6 +45,34 @@ static sint32 max_service = 1;
 
 static sint32 max_building_level = 0;
 
+#ifdef MULTI_THREAD
+#include "../utils/simthread.h"
+
+// several threads may raise the maxima during calc_map()
+static pthread_mutex_t maximum_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static void raise_maximum(sint32 &maximum, const sint32 value)
+{
+	if(  value > maximum  ) {
+#ifdef MULTI_THREAD
+		pthread_mutex_lock( &maximum_mutex );
+		if(  value > maximum  ) {
+			maximum = value;
+		}
+		pthread_mutex_unlock( &maximum_mutex );
+#else
+		maximum = value;
+#endif
+	}
+}
+
+// size of the blocks for the dirty tile tracking
+#define MAP_DIRTY_BLOCK_SHIFT (5)
+
+// each thread should at least get this many rows of tiles
+#define MIN_ROWS_PER_THREAD (16)
+
 minimap_t * minimap_t::single_instance = nullptr;
 karte_ptr_t minimap_t::world;
 
@@ -881,9 +910,7 @@ void minimap_t::calc_map_pixel(const koord k)
 					if(w) {
 						cargo += w->get_statistics(WAY_STAT_GOODS);
 					}
-					if(  cargo > max_cargo  ) {
-						max_cargo = cargo;
-					}
+					raise_maximum( max_cargo, cargo );
 					set_map_color(k, calc_severity_color_log(cargo, max_cargo));
 				}
 			}
@@ -907,9 +934,7 @@ void minimap_t::calc_map_pixel(const koord k)
 					if(  weg_t *w=gr->get_weg_nr(1)  ) {
 						passed += w->get_statistics(WAY_STAT_CONVOIS);
 					}
-					if(  passed > max_passed  ) {
-						max_passed = passed;
-					}
+					raise_maximum( max_passed, passed );
 					set_map_color(k, calc_severity_color_log( passed, max_passed ) );
 				}
 			}
@@ -1061,9 +1086,7 @@ void minimap_t::calc_map_pixel(const koord k)
 				if(  gebaeude_t *gb = gr->find<gebaeude_t>()  ) {
 					if(  gb->is_city_building()  ) {
 						sint32 level = gb->get_tile()->get_desc()->get_level();
-						if(  level > max_building_level  ) {
-							max_building_level = level;
-						}
+						raise_maximum( max_building_level, level );
 						set_map_color(k, calc_severity_color(level, max_building_level));
 					}
 				}
@@ -1184,6 +1207,80 @@ void minimap_t::calc_map_size()
 }
 
 
+#ifdef MULTI_THREAD
+struct minimap_stripe_param_t
+{
+	minimap_t *map;
+	koord start, end;
+	sint16 step;
+};
+
+
+static void *calc_map_stripe_thread(void *ptr)
+{
+	const minimap_stripe_param_t *param = reinterpret_cast<const minimap_stripe_param_t *>(ptr);
+	koord k;
+	for(  k.y=param->start.y;  k.y<param->end.y;  k.y+=param->step  ) {
+		for(  k.x=param->start.x;  k.x<param->end.x;  k.x+=param->step  ) {
+			param->map->calc_map_pixel(k);
+		}
+	}
+	return NULL;
+}
+#endif
+
+
+void minimap_t::calc_map_area(koord start, koord end, sint16 step)
+{
+#ifdef MULTI_THREAD
+	// calc_map_pixel() only reads the world and writes the pixels of its tile.
+	// In isometric view these overlap with the pixels of rows up to 1.5*zoom_out apart,
+	// so the first rows of each stripe are left out and calculated after the threads.
+	const sint32 overlap = isometric ? 2 * zoom_out : 0;
+	const sint32 rows = (end.y - start.y + step - 1) / step;
+	const int num_threads = min( (int)env_t::num_threads, (int)(rows / (MIN_ROWS_PER_THREAD + overlap)) );
+	if(  num_threads > 1  ) {
+		pthread_t thread[MAX_THREADS];
+		minimap_stripe_param_t param[MAX_THREADS];
+		for(  int t = 0;  t < num_threads;  t++  ) {
+			param[t].map = this;
+			param[t].start = koord( start.x, start.y + ((rows * t) / num_threads + (t > 0 ? overlap : 0)) * step );
+			param[t].end = koord( end.x, min( end.y, (sint16)(start.y + ((rows * (t+1)) / num_threads) * step) ) );
+			param[t].step = step;
+		}
+		int spawned = 1;
+		for(  ;  spawned < num_threads;  spawned++  ) {
+			if(  pthread_create( &thread[spawned], NULL, calc_map_stripe_thread, (void *)&param[spawned] )  ) {
+				break;
+			}
+		}
+		calc_map_stripe_thread( &param[0] );
+		for(  int t = 1;  t < spawned;  t++  ) {
+			pthread_join( thread[t], NULL );
+		}
+		// if thread creation failed, do the rest ourselves
+		for(  int t = spawned;  t < num_threads;  t++  ) {
+			calc_map_stripe_thread( &param[t] );
+		}
+		// finally the overlapping rows between the stripes
+		for(  int t = 1;  t < num_threads  &&  overlap > 0;  t++  ) {
+			minimap_stripe_param_t boundary = param[t];
+			boundary.end.y = boundary.start.y;
+			boundary.start.y -= overlap * step;
+			calc_map_stripe_thread( &boundary );
+		}
+		return;
+	}
+#endif
+	koord k;
+	for(  k.y=start.y;  k.y<end.y;  k.y+=step  ) {
+		for(  k.x=start.x;  k.x<end.x;  k.x+=step  ) {
+			calc_map_pixel(k);
+		}
+	}
+}
+
+
 void minimap_t::calc_map()
 {
 	// only use bitmap size like screen size
@@ -1198,28 +1295,58 @@ void minimap_t::calc_map()
 	needs_redraw = false;
 	is_visible = true;
 
-	// redraw the map
-	if(  !isometric  ) {
-		koord k;
-		koord start_off = koord( (cur_off.x*zoom_out)/zoom_in, (cur_off.y*zoom_out)/zoom_in );
-		koord end_off = start_off+koord( ( map_data->get_width()*zoom_out)/zoom_in+1, ( map_data->get_height()*zoom_out)/zoom_in+1 );
-		for(  k.y=start_off.y;  k.y<end_off.y;  k.y+=zoom_out  ) {
-			for(  k.x=start_off.x;  k.x<end_off.x;  k.x+=zoom_out  ) {
-				calc_map_pixel(k);
-			}
-		}
+	// everything is recalculated anyway
+	if(  dirty_blocks  &&  any_dirty_blocks  ) {
+		dirty_blocks->init( 0 );
+		any_dirty_blocks = false;
 	}
-	else {
-		// always the whole map ...
-        map_data->init( color_idx_to_rgb(COL_BLACK) );
-		koord k;
-		for(  k.y=0;  k.y < world->get_size().y;  k.y++  ) {
-			for(  k.x=0;  k.x < world->get_size().x;  k.x++  ) {
-				calc_map_pixel(k);
+
+	// calc_map_pixel() would otherwise do a full recalculation on its own to find the maximum
+	// => find it with a first pass
+	int passes = 1;
+	switch(  mode & ~MAP_MODE_FLAGS  ) {
+		case MAP_FREIGHT:
+			if(  max_cargo == 0  ) {
+				max_cargo = 1;
+				passes = 2;
+			}
+			break;
+		case MAP_TRAFFIC:
+			if(  max_passed == 0  ) {
+				max_passed = 1;
+				passes = 2;
+			}
+			break;
+		case MAP_LEVEL:
+			if(  max_building_level == 0  ) {
+				max_building_level = 1;
+				passes = 2;
 			}
+			break;
+		default:
+			break;
+	}
+
+	// redraw the map
+	while(  passes-- > 0  ) {
+		if(  !isometric  ) {
+			koord start_off = koord( (cur_off.x*zoom_out)/zoom_in, (cur_off.y*zoom_out)/zoom_in );
+			koord end_off = start_off+koord( ( map_data->get_width()*zoom_out)/zoom_in+1, ( map_data->get_height()*zoom_out)/zoom_in+1 );
+			calc_map_area( start_off, end_off, zoom_out );
+		}
+		else {
+			// always the whole map ...
+			map_data->init( color_idx_to_rgb(COL_BLACK) );
+			calc_map_area( koord(0,0), world->get_size(), 1 );
 		}
 	}
 
+	calc_map_overlays();
+}
+
+
+void minimap_t::calc_map_overlays()
+{
 	// since we do iterate the tourist info list, this must be done here
 	// find tourist spots
 	if(mode==MAP_TOURIST) {
@@ -1265,6 +1392,55 @@ void minimap_t::calc_map()
 }
 
 
+void minimap_t::invalidate_map_area(koord lo, koord hi)
+{
+	if(  dirty_blocks == nullptr  ) {
+		return;
+	}
+	lo.clip_min( koord(0,0) );
+	hi.clip_max( world->get_size() - koord(1,1) );
+	for(  sint16 by = lo.y >> MAP_DIRTY_BLOCK_SHIFT;  by <= (hi.y >> MAP_DIRTY_BLOCK_SHIFT);  by++  ) {
+		for(  sint16 bx = lo.x >> MAP_DIRTY_BLOCK_SHIFT;  bx <= (hi.x >> MAP_DIRTY_BLOCK_SHIFT);  bx++  ) {
+			dirty_blocks->at( bx, by ) = 1;
+			any_dirty_blocks = true;
+		}
+	}
+}
+
+
+void minimap_t::calc_dirty_blocks()
+{
+	any_dirty_blocks = false;
+	const sint16 block_size = 1 << MAP_DIRTY_BLOCK_SHIFT;
+	// when zoomed out, only every zoom_out-th tile is shown (same ones as in calc_map())
+	const sint16 step = isometric ? 1 : zoom_out;
+	const koord origin = isometric ? koord(0,0) : koord( (cur_off.x*zoom_out)/zoom_in, (cur_off.y*zoom_out)/zoom_in );
+	for(  uint32 by = 0;  by < dirty_blocks->get_height();  by++  ) {
+		// join the dirty blocks of a row into spans
+		uint32 bx = 0;
+		while(  bx < dirty_blocks->get_width()  ) {
+			if(  dirty_blocks->at( bx, by ) == 0  ) {
+				bx++;
+				continue;
+			}
+			const uint32 first = bx;
+			while(  bx < dirty_blocks->get_width()  &&  dirty_blocks->at( bx, by )  ) {
+				dirty_blocks->at( bx, by ) = 0;
+				bx++;
+			}
+			koord start( first * block_size, by * block_size );
+			koord end( min( (sint32)(bx * block_size), (sint32)world->get_size().x ), min( (sint32)((by + 1) * block_size), (sint32)world->get_size().y ) );
+			if(  step > 1  ) {
+				start.x += (step - ((start.x - origin.x) % step + step) % step) % step;
+				start.y += (step - ((start.y - origin.y) % step + step) % step) % step;
+			}
+			calc_map_area( start, end, step );
+		}
+	}
+	calc_map_overlays();
+}
+
+
 minimap_t::minimap_t(){
 	mode = MAP_TOWN;
 }
@@ -1294,6 +1470,10 @@ void minimap_t::init()
 	//show_buildings = true;
 
 	calc_map_size();
+	delete dirty_blocks;
+	dirty_blocks = new array2d_tpl<uint8>( ((world->get_size().x - 1) >> MAP_DIRTY_BLOCK_SHIFT) + 1, ((world->get_size().y - 1) >> MAP_DIRTY_BLOCK_SHIFT) + 1 );
+	dirty_blocks->init( 0 );
+	any_dirty_blocks = false;
 	max_building_level = max_cargo = max_passed = 0;
 	max_tourist_ziele = max_waiting = max_origin = max_transfer = max_service = 1;
 	last_schedule_counter = world->get_schedule_counter()-1;
@@ -1303,6 +1483,9 @@ void minimap_t::init()
 void minimap_t::finalize(){
 	delete map_data;
 	map_data = nullptr;
+	delete dirty_blocks;
+	dirty_blocks = nullptr;
+	any_dirty_blocks = false;
 }
 
 
@@ -1315,6 +1498,7 @@ void minimap_t::set_display_mode(MAP_DISPLAY_MODE new_mode)
 
 void minimap_t::new_month()
 {
+	// statistics changed, and not every change of a tile is tracked in the dirty blocks
 	needs_redraw = true;
 }
 
@@ -1438,6 +1622,9 @@ void minimap_t::draw(scr_coord pos)
 		calc_map();
 		needs_redraw = false;
 	}
+	else if(  any_dirty_blocks  ) {
+		calc_dirty_blocks();
+	}
 
 	if( map_data==nullptr) {
 		return;
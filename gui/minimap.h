@@ -172,6 +172,22 @@ private:
 	/// true, if full redraw is needed
 	bool needs_redraw{true};
 
+	/**
+	 * Tiles changed since the last draw, in blocks of (1<<MAP_DIRTY_BLOCK_SHIFT)^2 tiles.
+	 * Only these are recalculated in draw() instead of the whole map.
+	 */
+	array2d_tpl<uint8> *dirty_blocks{nullptr};
+	bool any_dirty_blocks{false};
+
+	/// recalculates all tiles in the dirty blocks
+	void calc_dirty_blocks();
+
+	/// recalculates every step-th tile in [start,end) with several threads (if available)
+	void calc_map_area(koord start, koord end, sint16 step);
+
+	/// overlays of attractions, factories and depots (over the ground colors)
+	void calc_map_overlays();
+
 	const fabrik_t* get_factory_near(koord pos, bool large_area) const;
 
 	const fabrik_t* draw_factory_connections(const fabrik_t* const fab, bool supplier_link, const scr_coord pos) const;
@@ -240,6 +256,9 @@ public:
 
 	void calc_map();
 
+	/// marks all tiles in the rectangle lo..hi (inclusive) for recalculation on the next draw
+	void invalidate_map_area(koord lo, koord hi);
+
 	/// calculates the current size of the map (but do not change anything else)
 	void calc_map_size();
 
@@ -125,7 +125,8 @@ static const char *revision_ex[] =
 	"40",
 	"41",
 	"42",
-	"43"
+	"43",
+	"44"
 };
 
 
@@ -253,6 +254,7 @@ void settings_extended_general_stats_t::init( settings_t *sets )
 	INIT_NUM("do_not_record_private_car_routes_to_city_industries", sets->get_do_not_record_private_car_routes_to_city_industries(), 0, 65535, gui_numberinput_t::PLAIN, false);
 	INIT_BOOL("do_not_record_private_car_routes_to_distant_non_consumer_industries ", sets->get_do_not_record_private_car_routes_to_distant_non_consumer_industries());
 	INIT_BOOL("do_not_record_private_car_routes_to_city_buildings", sets->get_do_not_record_private_car_routes_to_city_buildings());
+	INIT_NUM("private_car_flows", sets->get_private_car_flows(), 0, 2, gui_numberinput_t::PLAIN, false);
 
 	INIT_END
 }
@@ -365,6 +367,7 @@ void settings_extended_general_stats_t::read(settings_t *sets)
 	READ_NUM_VALUE(sets->private_car_route_to_industry_visitor_demand_threshold);
 	READ_BOOL_VALUE(sets->do_not_record_private_car_routes_to_distant_non_consumer_industries);
 	READ_BOOL_VALUE(sets->do_not_record_private_car_routes_to_city_buildings);
+	READ_NUM_VALUE(sets->private_car_flows);
 
 	path_explorer_t::set_absolute_limits_external();
 }
@@ -27,10 +27,19 @@
 #include "../utils/simstring.h"
 #include "../utils/fetchopt.h"
 #include "../utils/sha1.h"
+#include "soak.h"
 
 
+// all other commands, their packet is read by the caller
+class nwc_raw_t : public network_command_t
+{
+public:
+	nwc_raw_t(uint16 id) : network_command_t(id) {}
+	const char* get_name() OVERRIDE { return "nwc_raw_t"; }
+};
+
 // dummy implementation
-// only receive nwc_service_t here
+// only decode nwc_service_t here
 // called from network_check_activity
 network_command_t* network_command_t::read_from_packet(packet_t *p)
 {
@@ -44,7 +53,12 @@ network_command_t* network_command_t::read_from_packet(packet_t *p)
 	switch (p->get_id()) {
 		case NWC_SERVICE:     nwc = new nwc_service_t(); break;
 		default:
-			dbg->warning("network_command_t::read_from_socket", "received unknown packet id %d", p->get_id());
+			if (p->get_id() < NWC_COUNT) {
+				nwc = new nwc_raw_t(p->get_id());
+			}
+			else {
+				dbg->warning("network_command_t::read_from_socket", "received unknown packet id %d", p->get_id());
+			}
 	}
 	if (nwc) {
 		if (!nwc->receive(p) ||  p->has_failed()) {
@@ -444,6 +458,18 @@ void usage()
 		"      force-sync\n"
 		"        Force server to send sync command in order to save & reload the game\n"
 		"\n"
+		"      record <seconds> <filename>\n"
+		"        Join a server on this machine and save the tool commands of all players\n"
+		"\n"
+		"      soak <clients> <seconds> <recording> [<commands per second> [<server pid>]]\n"
+		"        Load test of a server on this machine: the clients join one after another,\n"
+		"        then each replays the recording (use '-' for none) at the given rate per\n"
+		"        client, or with the recorded timing if no rate is given. Measures join time,\n"
+		"        round trip of tool commands, drift of NWC_CHECK and, with the pid of the\n"
+		"        server on Linux, its CPU time per sync step. Writes soak-report.txt.\n"
+		"        The simulated clients do not load the game; set server_hot_join = 1 in\n"
+		"        simuconf.tab, otherwise every join makes the server save and reload.\n"
+		"\n"
 		"    Return codes:\n"
 		"      0 .. success\n"
 		"      1 .. server not reachable\n"
@@ -548,7 +574,10 @@ int main(int argc, char* argv[]) {
 		{"info-company",   true,  nwc_service_t::SRVC_GET_COMPANY_INFO, 1, &simple_gettext_command},
 		{"unlock-company", true,  nwc_service_t::SRVC_UNLOCK_COMPANY,   1, &simple_command},
 		{"remove-company", true,  nwc_service_t::SRVC_REMOVE_COMPANY,   1, &simple_command},
-		{"lock-company",   true,  nwc_service_t::SRVC_LOCK_COMPANY,     2, &lock_company}
+		{"lock-company",   true,  nwc_service_t::SRVC_LOCK_COMPANY,     2, &lock_company},
+		// these open their own connections, see below
+		{"record",         false, 0,                                    2, NULL},
+		{"soak",           false, 0,                                    3, NULL}
 	};
 	int numcommands = lengthof(commands);
 
@@ -588,6 +617,25 @@ int main(int argc, char* argv[]) {
 		printf("\n");
 	}
 
+	const int first_arg = fetchopt.get_optind() + 1;
+	char **argv_in;
+	int argc_in;
+	if (first_arg >= argc) {
+		argv_in = NULL;
+		argc_in = 0;
+	} else {
+		argv_in = argv + first_arg;
+		argc_in = argc - first_arg;
+	}
+
+	// the load test connects once per simulated client
+	if(  strcmp(commands[cmdindex].name, "record")==0  ) {
+		return soak_record(server_address, argc_in, argv_in);
+	}
+	if(  strcmp(commands[cmdindex].name, "soak")==0  ) {
+		return soak_test(server_address, argc_in, argv_in);
+	}
+
 	// This is done whether we're executing a password protected command or not...
 	const char *error = NULL;
 	SOCKET const socket = network_open_address(server_address, error);
@@ -625,15 +673,5 @@ int main(int argc, char* argv[]) {
 	}
 
 	// Execute command function and exit with return code
-	const int first_arg = fetchopt.get_optind() + 1;
-	char **argv_in;
-	int argc_in;
-	if (first_arg >= argc) {
-		argv_in = NULL;
-		argc_in = 0;
-	} else {
-		argv_in = argv + first_arg;
-		argc_in = argc - first_arg;
-	}
 	return commands[cmdindex].func(socket, commands[cmdindex].command_id, argc_in, argv_in);
 }
@@ -0,0 +1,902 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include "soak.h"
+#include "../network/memory_rw.h"
+#include "../network/network.h"
+#include "../network/network_cmd.h"
+#include "../network/network_packet.h"
+#include "../network/network_socket_list.h"
+#include "../simdebug.h"
+#include "../simmem.h"
+#include "../simtypes.h"
+#include "../tpl/vector_tpl.h"
+#include "../utils/plainstring.h"
+
+
+// size of checklist_t::rdwr(): two sync steps, nfc, random seed, three entry counts,
+// CHK_RANDS random numbers and CHK_DEBUG_SUMS debug sums
+#define CHECKLIST_SIZE (4+4+1+4+3*2+32*4+10*4)
+
+// tool commands without echo after this time are lost
+#define ECHO_TIMEOUT (10000)
+
+// joins not finished after this time have failed
+#define JOIN_TIMEOUT (300000)
+
+// all sockets must fit into the fd_set of network_check_activity()
+#define MAX_CLIENTS (250)
+
+#define REPORT_FILE "soak-report.txt"
+
+#define RECORDING_MAGIC "SOAK"
+#define RECORDING_VERSION (1)
+
+
+// milliseconds since the first call, never zero
+static uint32 get_time_ms()
+{
+#ifdef _WIN32
+	const sint64 now = GetTickCount();
+#else
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	const sint64 now = (sint64)tv.tv_sec*1000 + tv.tv_usec/1000;
+#endif
+	static sint64 start = now;
+	return (uint32)(now - start) + 1;
+}
+
+
+// cpu time used by the process in milliseconds, only available on linux
+static bool get_process_cpu_ms(int pid, uint64 &cpu_ms)
+{
+#ifdef __linux__
+	char fn[64];
+	sprintf(fn, "/proc/%d/stat", pid);
+	FILE *f = fopen(fn, "r");
+	if(  f==NULL  ) {
+		return false;
+	}
+	char buf[1024];
+	const size_t len = fread(buf, 1, sizeof(buf)-1, f);
+	fclose(f);
+	buf[len] = 0;
+	// the name of the process may contain spaces and brackets
+	const char *p = strrchr(buf, ')');
+	unsigned long utime, stime;
+	if(  p==NULL  ||  sscanf(p+1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &utime, &stime)!=2  ) {
+		return false;
+	}
+	cpu_ms = (uint64)(utime + stime) * 1000 / sysconf(_SC_CLK_TCK);
+	return true;
+#else
+	(void)pid;
+	(void)cpu_ms;
+	return false;
+#endif
+}
+
+
+// only servers on this machine may be loaded with simulated clients
+static bool is_loopback(const char *address)
+{
+	static const char *hosts[] = { "localhost", "[::1]", "::1" };
+	for(  uint32 i=0;  i<lengthof(hosts);  i++  ) {
+		const size_t len = strlen(hosts[i]);
+		if(  strncmp(address, hosts[i], len)==0  &&  (address[len]==0  ||  address[len]==':')  ) {
+			return true;
+		}
+	}
+	return strncmp(address, "127.", 4)==0  &&  strspn(address, "0123456789.:")==strlen(address);
+}
+
+
+static uint32 hash_bytes(const uint8 *data, uint32 len)
+{
+	uint32 hash = 2166136261u;
+	for(  uint32 i=0;  i<len;  i++  ) {
+		hash = (hash ^ data[i]) * 16777619u;
+	}
+	return hash;
+}
+
+
+/// a tool command: everything of nwc_tool_t after the checklist
+struct recorded_tool_t
+{
+	/// milliseconds since the start of the recording
+	uint32 time;
+	uint16 len;
+	/// length of the fields player_nr .. init, which the server does not change
+	uint16 key_len;
+	uint32 key;
+	uint8 *data;
+
+	recorded_tool_t() : time(0), len(0), key_len(0), key(0), data(NULL) {}
+	~recorded_tool_t() { free(data); }
+
+	/// finds the key, returns false if the data are no tool command
+	bool init(uint32 &tool_client_id)
+	{
+		memory_rw_t mem(data, len, false);
+		uint8 player_nr, posz;
+		bool tool_init;
+		sint16 posx, posy;
+		uint16 tool_id, wt;
+		plainstring default_param;
+		mem.rdwr_byte(player_nr);
+		mem.rdwr_short(posx);
+		mem.rdwr_short(posy);
+		mem.rdwr_byte(posz);
+		mem.rdwr_short(tool_id);
+		mem.rdwr_short(wt);
+		mem.rdwr_str(default_param);
+		mem.rdwr_bool(tool_init);
+		key_len = mem.get_current_index();
+		mem.rdwr_long(tool_client_id);
+		key = hash_bytes(data, key_len);
+		return !mem.is_overflow();
+	}
+};
+
+
+/// join request of nwc_join_t: no compression of the game and no resume
+class nwc_soak_join_t : public network_command_t
+{
+public:
+	plainstring nickname;
+
+	nwc_soak_join_t(const char *nick) : network_command_t(NWC_JOIN), nickname(nick) {}
+
+	void rdwr() OVERRIDE
+	{
+		network_command_t::rdwr();
+		packet->rdwr_str(nickname);
+		uint32 client_id = 0;
+		packet->rdwr_long(client_id);
+		uint8 answer = 0, compression = 0;
+		packet->rdwr_byte(answer);
+		packet->rdwr_byte(compression);
+		uint32 resume_offset = 0;
+		packet->rdwr_long(resume_offset);
+		uint8 resume_checksum[20];
+		memset(resume_checksum, 0, sizeof(resume_checksum));
+		packet->rdwr_bytes(resume_checksum, sizeof(resume_checksum));
+	}
+
+	const char* get_name() OVERRIDE { return "nwc_soak_join_t"; }
+};
+
+
+/// nwc_tool_t as sent by a client, with the checklist of the last NWC_CHECK
+class nwc_soak_tool_t : public network_command_t
+{
+public:
+	uint32 sync_step;
+	uint32 map_counter;
+	uint8 *checklist;
+	recorded_tool_t *tool;
+
+	nwc_soak_tool_t(uint32 client_id, uint32 sync_step_, uint32 map_counter_, uint8 *checklist_, recorded_tool_t *tool_)
+		: network_command_t(NWC_TOOL), sync_step(sync_step_), map_counter(map_counter_), checklist(checklist_), tool(tool_)
+	{
+		our_client_id = client_id;
+	}
+
+	void rdwr() OVERRIDE
+	{
+		network_command_t::rdwr();
+		packet->rdwr_long(sync_step);
+		packet->rdwr_long(map_counter);
+		bool exec = false;
+		packet->rdwr_bool(exec);
+		// last_sync_step: the checklist belongs to the sync step of the check
+		packet->rdwr_long(sync_step);
+		packet->rdwr_bytes(checklist, CHECKLIST_SIZE);
+		packet->rdwr_bytes(tool->data, tool->len);
+	}
+
+	const char* get_name() OVERRIDE { return "nwc_soak_tool_t"; }
+};
+
+
+struct check_sample_t
+{
+	uint32 time;
+	uint32 server_sync_step;
+};
+
+
+struct pending_tool_t
+{
+	uint32 time;
+	uint32 key;
+};
+
+
+/// a client which only speaks the protocol and never loads the game
+struct sim_client_t
+{
+	enum state_t { WAITING, JOINING, LOADING, PLAYING, LEFT };
+
+	uint32 nr;
+	state_t state;
+	SOCKET sock;
+	uint32 client_id;
+
+	/// time of the first connect, the join time is measured from here
+	uint32 join_start;
+	/// time of the next connect while waiting
+	uint32 next_connect;
+	/// milliseconds until NWC_READY
+	uint32 join_time;
+	uint32 game_len;
+	uint32 game_received;
+
+	/// the last NWC_CHECK, sent back with every tool command
+	bool has_check;
+	uint32 map_counter;
+	uint32 server_sync_step;
+	uint8 checklist[CHECKLIST_SIZE];
+
+	vector_tpl<check_sample_t> checks;
+
+	/// next recorded command to replay
+	uint32 next_tool;
+	uint32 next_send;
+	/// commands waiting for the echo of the server
+	vector_tpl<pending_tool_t> pending;
+
+	uint32 sent;
+	uint32 answered;
+	uint32 lost;
+	bool disconnected;
+
+	sim_client_t(uint32 nr_) : nr(nr_), state(WAITING), sock(INVALID_SOCKET), client_id(0),
+		join_start(0), next_connect(0), join_time(0), game_len(0), game_received(0),
+		has_check(false), map_counter(0), server_sync_step(0),
+		next_tool(0), next_send(0), sent(0), answered(0), lost(0), disconnected(false)
+	{
+		memset(checklist, 0, sizeof(checklist));
+	}
+
+	bool is_connected() const { return state==JOINING  ||  state==LOADING  ||  state==PLAYING; }
+};
+
+
+class soak_t
+{
+public:
+	const char *server_address;
+	vector_tpl<sim_client_t*> clients;
+	vector_tpl<recorded_tool_t*> tools;
+
+	/// saves the tool commands of the first client instead of replaying
+	bool recording;
+	uint32 record_start;
+
+	/// commands per second and client, zero keeps the recorded timing
+	double rate;
+
+	/// pid of the server, zero if unknown
+	int server_pid;
+
+	vector_tpl<uint32> round_trips;
+
+	/// the measured period after all clients have joined
+	uint32 play_start, play_end;
+	uint32 steps_start, steps_end;
+	uint64 cpu_start, cpu_end;
+	bool has_cpu;
+
+	soak_t(const char *address, uint32 count, double rate_, int pid, bool record) :
+		server_address(address), recording(record), record_start(0), rate(rate_), server_pid(pid),
+		play_start(0), play_end(0), steps_start(0), steps_end(0), cpu_start(0), cpu_end(0), has_cpu(false)
+	{
+		for(  uint32 i=0;  i<count;  i++  ) {
+			clients.append(new sim_client_t(i));
+		}
+	}
+
+	~soak_t()
+	{
+		clear_ptr_vector(clients);
+		clear_ptr_vector(tools);
+	}
+
+	bool load_recording(const char *filename);
+	bool save_recording(const char *filename) const;
+
+	/// joins all clients one after another and replays for @p seconds
+	void run(uint32 seconds);
+
+	void write_report(FILE *f) const;
+
+private:
+	sim_client_t *find_client(SOCKET sock) const;
+
+	void connect(sim_client_t *c, uint32 now);
+	void disconnect(sim_client_t *c, sim_client_t::state_t state);
+
+	void receive(network_command_t *nwc, uint32 now);
+	void receive_tool(sim_client_t *c, packet_t *p, uint32 now);
+
+	void send_tools(sim_client_t *c, uint32 now);
+
+	/// the latest sync step any client has seen
+	uint32 get_server_sync_step() const;
+};
+
+
+bool soak_t::load_recording(const char *filename)
+{
+	FILE *f = fopen(filename, "rb");
+	if(  f==NULL  ) {
+		fprintf(stderr, "Could not open recording %s\n", filename);
+		return false;
+	}
+	char magic[4];
+	uint8 header[6];
+	bool ok = fread(magic, 1, 4, f)==4  &&  memcmp(magic, RECORDING_MAGIC, 4)==0  &&  fread(header, 1, 4, f)==4;
+	if(  ok  ) {
+		memory_rw_t mem(header, 4, false);
+		uint32 version;
+		mem.rdwr_long(version);
+		ok = version==RECORDING_VERSION;
+	}
+	while(  ok  &&  fread(header, 1, 6, f)==6  ) {
+		memory_rw_t mem(header, 6, false);
+		recorded_tool_t *tool = new recorded_tool_t();
+		mem.rdwr_long(tool->time);
+		mem.rdwr_short(tool->len);
+		tool->data = MALLOCN(uint8, tool->len);
+		uint32 tool_client_id;
+		ok = fread(tool->data, 1, tool->len, f)==tool->len  &&  tool->init(tool_client_id);
+		tools.append(tool);
+	}
+	fclose(f);
+	if(  !ok  ) {
+		fprintf(stderr, "Recording %s is damaged\n", filename);
+	}
+	return ok;
+}
+
+
+bool soak_t::save_recording(const char *filename) const
+{
+	FILE *f = fopen(filename, "wb");
+	if(  f==NULL  ) {
+		fprintf(stderr, "Could not write recording %s\n", filename);
+		return false;
+	}
+	uint8 header[6];
+	memory_rw_t mem(header, 4, true);
+	uint32 version = RECORDING_VERSION;
+	mem.rdwr_long(version);
+	fwrite(RECORDING_MAGIC, 1, 4, f);
+	fwrite(header, 1, 4, f);
+	FOR(vector_tpl<recorded_tool_t*>, const tool, tools) {
+		memory_rw_t mem(header, 6, true);
+		mem.rdwr_long(tool->time);
+		mem.rdwr_short(tool->len);
+		fwrite(header, 1, 6, f);
+		fwrite(tool->data, 1, tool->len, f);
+	}
+	const bool ok = !ferror(f);
+	fclose(f);
+	return ok;
+}
+
+
+sim_client_t *soak_t::find_client(SOCKET sock) const
+{
+	FOR(vector_tpl<sim_client_t*>, const c, clients) {
+		if(  c->is_connected()  &&  c->sock==sock  ) {
+			return c;
+		}
+	}
+	return NULL;
+}
+
+
+void soak_t::connect(sim_client_t *c, uint32 now)
+{
+	if(  c->join_start==0  ) {
+		c->join_start = now;
+	}
+	const char *err = NULL;
+	c->sock = network_open_address(server_address, err);
+	if(  err  ) {
+		dbg->warning("soak_t::connect", "client %u could not connect: %s", c->nr, err);
+		c->sock = INVALID_SOCKET;
+		c->state = sim_client_t::LEFT;
+		return;
+	}
+	socket_list_t::add_client(c->sock);
+
+	char nick[32];
+	sprintf(nick, "soak%u", c->nr);
+	nwc_soak_join_t nwj(nick);
+	if(  !nwj.send(c->sock)  ) {
+		disconnect(c, sim_client_t::WAITING);
+		c->next_connect = now + 1000;
+		return;
+	}
+	c->state = sim_client_t::JOINING;
+}
+
+
+void soak_t::disconnect(sim_client_t *c, sim_client_t::state_t state)
+{
+	if(  c->sock!=INVALID_SOCKET  &&  socket_list_t::has_client(c->sock)  ) {
+		socket_list_t::remove_client(c->sock);
+	}
+	c->sock = INVALID_SOCKET;
+	c->state = state;
+}
+
+
+void soak_t::receive(network_command_t *nwc, uint32 now)
+{
+	sim_client_t *c = find_client(nwc->get_sender());
+	if(  c==NULL  ) {
+		return;
+	}
+	packet_t *p = nwc->get_packet();
+	switch(  nwc->get_id()  ) {
+		case NWC_JOIN: {
+			plainstring nick;
+			uint32 client_id;
+			uint8 answer;
+			p->rdwr_str(nick);
+			p->rdwr_long(client_id);
+			p->rdwr_byte(answer);
+			if(  c->state!=sim_client_t::JOINING  ) {
+				break;
+			}
+			if(  answer==1  ) {
+				c->client_id = client_id;
+				c->state = sim_client_t::LOADING;
+			}
+			else {
+				// server busy with another join: try again
+				disconnect(c, sim_client_t::WAITING);
+				c->next_connect = now + 1000;
+			}
+			break;
+		}
+
+		case NWC_GAME:
+			p->rdwr_long(c->game_len);
+			break;
+
+		case NWC_GAME_CHUNK: {
+			uint32 offset;
+			uint16 len;
+			p->rdwr_long(offset);
+			p->rdwr_short(len);
+			c->game_received += len;
+			break;
+		}
+
+		case NWC_READY:
+			if(  c->state==sim_client_t::LOADING  ) {
+				c->state = sim_client_t::PLAYING;
+				c->join_time = now - c->join_start;
+				c->next_send = now;
+				if(  recording  &&  record_start==0  ) {
+					record_start = now;
+				}
+			}
+			break;
+
+		case NWC_SYNC: {
+			uint32 sync_step, map_counter, client_id;
+			p->rdwr_long(sync_step);
+			p->rdwr_long(map_counter);
+			p->rdwr_long(client_id);
+			p->rdwr_long(c->map_counter);
+			break;
+		}
+
+		case NWC_CHECK: {
+			uint32 sync_step;
+			p->rdwr_long(sync_step);
+			p->rdwr_long(c->map_counter);
+			p->rdwr_bytes(c->checklist, CHECKLIST_SIZE);
+			p->rdwr_long(c->server_sync_step);
+			if(  !p->has_failed()  ) {
+				c->has_check = true;
+				check_sample_t sample;
+				sample.time = now;
+				sample.server_sync_step = c->server_sync_step;
+				c->checks.append(sample);
+			}
+			break;
+		}
+
+		case NWC_TOOL:
+			receive_tool(c, p, now);
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+void soak_t::receive_tool(sim_client_t *c, packet_t *p, uint32 now)
+{
+	uint32 sync_step, map_counter, last_sync_step;
+	bool exec;
+	p->rdwr_long(sync_step);
+	p->rdwr_long(map_counter);
+	p->rdwr_bool(exec);
+	if(  !exec  ||  c->state!=sim_client_t::PLAYING  ) {
+		return;
+	}
+	p->rdwr_long(last_sync_step);
+	uint8 checklist[CHECKLIST_SIZE];
+	p->rdwr_bytes(checklist, CHECKLIST_SIZE);
+
+	uint8 buf[MAX_PACKET_LEN];
+	memory_rw_t tail(buf, sizeof(buf), true);
+	tail.append_tail(*p);
+	if(  p->has_failed()  ||  tail.is_overflow()  ) {
+		return;
+	}
+
+	recorded_tool_t tool;
+	tool.data = buf;
+	tool.len = tail.get_current_index();
+	uint32 tool_client_id;
+	const bool ok = tool.init(tool_client_id);
+	tool.data = NULL;
+	if(  !ok  ) {
+		return;
+	}
+
+	if(  recording  ) {
+		recorded_tool_t *rec = new recorded_tool_t();
+		rec->time = now - record_start;
+		rec->len = tool.len;
+		rec->key_len = tool.key_len;
+		rec->key = tool.key;
+		rec->data = MALLOCN(uint8, tool.len);
+		memcpy(rec->data, buf, tool.len);
+		tools.append(rec);
+	}
+	else if(  tool_client_id==c->client_id  ) {
+		// echo of our own command: the server accepted it
+		for(  uint32 i=0;  i<c->pending.get_count();  i++  ) {
+			if(  c->pending[i].key==tool.key  ) {
+				round_trips.append(now - c->pending[i].time);
+				c->pending.remove_at(i);
+				c->answered++;
+				break;
+			}
+		}
+	}
+}
+
+
+void soak_t::send_tools(sim_client_t *c, uint32 now)
+{
+	if(  tools.empty()  ||  !c->has_check  ) {
+		return;
+	}
+	while(  c->state==sim_client_t::PLAYING  &&  (sint32)(now - c->next_send)>=0  ) {
+		recorded_tool_t *tool = tools[c->next_tool];
+		nwc_soak_tool_t nwt(c->client_id, c->server_sync_step, c->map_counter, c->checklist, tool);
+		if(  !nwt.send(c->sock)  ) {
+			c->disconnected = true;
+			disconnect(c, sim_client_t::LEFT);
+			return;
+		}
+		pending_tool_t pending;
+		pending.time = now;
+		pending.key = tool->key;
+		c->pending.append(pending);
+		c->sent++;
+
+		const uint32 next = (c->next_tool + 1) % tools.get_count();
+		if(  rate>0.0  ) {
+			c->next_send += std::max<uint32>(1, (uint32)(1000.0 / rate));
+		}
+		else {
+			// pause a second before the recording starts again
+			c->next_send += next==0 ? 1000 : tools[next]->time - tool->time;
+		}
+		c->next_tool = next;
+		// never catch up after a stall, this would flood the server
+		if(  (sint32)(now - c->next_send)>1000  ) {
+			c->next_send = now;
+		}
+	}
+}
+
+
+uint32 soak_t::get_server_sync_step() const
+{
+	uint32 sync_step = 0;
+	FOR(vector_tpl<sim_client_t*>, const c, clients) {
+		sync_step = std::max(sync_step, c->server_sync_step);
+	}
+	return sync_step;
+}
+
+
+void soak_t::run(uint32 seconds)
+{
+	// start every client at another position of the recording
+	FOR(vector_tpl<sim_client_t*>, const c, clients) {
+		c->next_tool = tools.empty() ? 0 : (c->nr * tools.get_count()) / clients.get_count();
+	}
+
+	uint32 now = get_time_ms();
+	while(  play_start==0  ||  (sint32)(now - play_end)<0  ) {
+		// receive everything
+		network_command_t *nwc = network_check_activity(NULL, 5);
+		now = get_time_ms();
+		while(  nwc  ) {
+			receive(nwc, now);
+			delete nwc;
+			nwc = network_get_received_command();
+		}
+
+		// connections closed by the server
+		uint32 joining = 0, connected = 0, waiting = 0;
+		FOR(vector_tpl<sim_client_t*>, const c, clients) {
+			if(  c->is_connected()  &&  !socket_list_t::has_client(c->sock)  ) {
+				dbg->warning("soak_t::run", "client %u was disconnected by the server", c->nr);
+				c->disconnected = true;
+				c->sock = INVALID_SOCKET;
+				c->state = sim_client_t::LEFT;
+			}
+			if(  (c->state==sim_client_t::JOINING  ||  c->state==sim_client_t::LOADING)  &&  now - c->join_start>JOIN_TIMEOUT  ) {
+				dbg->warning("soak_t::run", "client %u could not join in time", c->nr);
+				disconnect(c, sim_client_t::LEFT);
+			}
+			joining += c->state==sim_client_t::JOINING  ||  c->state==sim_client_t::LOADING;
+			connected += c->state==sim_client_t::PLAYING;
+			waiting += c->state==sim_client_t::WAITING;
+		}
+
+		// the server sends the game to one client at a time, so join one after another
+		if(  joining==0  ) {
+			FOR(vector_tpl<sim_client_t*>, const c, clients) {
+				if(  c->state==sim_client_t::WAITING  ) {
+					if(  c->join_start!=0  &&  now - c->join_start>JOIN_TIMEOUT  ) {
+						dbg->warning("soak_t::run", "client %u could not join in time", c->nr);
+						c->state = sim_client_t::LEFT;
+					}
+					else if(  (sint32)(now - c->next_connect)>=0  ) {
+						connect(c, now);
+						break;
+					}
+				}
+			}
+		}
+
+		if(  play_start==0  &&  joining==0  &&  waiting==0  ) {
+			play_start = now;
+			play_end = now + seconds*1000;
+			steps_start = get_server_sync_step();
+			has_cpu = server_pid>0  &&  get_process_cpu_ms(server_pid, cpu_start);
+			if(  !recording  ) {
+				printf("%u clients joined, running for %u seconds\n", connected, seconds);
+			}
+		}
+		if(  play_start!=0  &&  connected==0  ) {
+			// nobody left
+			play_end = now;
+			break;
+		}
+
+		FOR(vector_tpl<sim_client_t*>, const c, clients) {
+			send_tools(c, now);
+			// commands refused by the server have no echo
+			while(  !c->pending.empty()  &&  now - c->pending[0].time>ECHO_TIMEOUT  ) {
+				c->pending.remove_at(0);
+				c->lost++;
+			}
+		}
+	}
+
+	steps_end = get_server_sync_step();
+	has_cpu = has_cpu  &&  get_process_cpu_ms(server_pid, cpu_end);
+
+	FOR(vector_tpl<sim_client_t*>, const c, clients) {
+		disconnect(c, c->state==sim_client_t::PLAYING ? sim_client_t::LEFT : c->state);
+	}
+}
+
+
+static uint32 get_percentile(const vector_tpl<uint32> &sorted, uint32 percent)
+{
+	return sorted.empty() ? 0 : sorted[((sorted.get_count() - 1) * percent) / 100];
+}
+
+
+void soak_t::write_report(FILE *f) const
+{
+	fprintf(f, "Soak test of %s\n\n", server_address);
+
+	// joins
+	uint32 joined = 0, failed = 0, disconnected = 0;
+	uint32 join_min = 0xFFFFFFFFu, join_max = 0;
+	uint64 join_sum = 0, game_bytes = 0;
+	FOR(vector_tpl<sim_client_t*>, const c, clients) {
+		if(  c->join_time  ) {
+			joined++;
+			join_min = std::min(join_min, c->join_time);
+			join_max = std::max(join_max, c->join_time);
+			join_sum += c->join_time;
+			game_bytes = std::max<uint64>(game_bytes, c->game_len);
+		}
+		else {
+			failed++;
+		}
+		disconnected += c->disconnected;
+	}
+	fprintf(f, "Clients: %u, joined %u, failed %u, disconnected by the server %u\n", clients.get_count(), joined, failed, disconnected);
+	if(  joined  ) {
+		fprintf(f, "Join time [ms]: min %u, mean %u, max %u (game %u kB)\n", join_min, (uint32)(join_sum / joined), join_max, (uint32)(game_bytes / 1024));
+	}
+
+	// server
+	const uint32 duration = play_end - play_start;
+	const uint32 steps = steps_end - steps_start;
+	fprintf(f, "Measured: %u ms, %u sync steps", duration, steps);
+	if(  steps  ) {
+		fprintf(f, " (%.2f ms per sync step)", (double)duration / steps);
+	}
+	fprintf(f, "\n");
+	if(  has_cpu  &&  steps  ) {
+		const uint64 cpu = cpu_end - cpu_start;
+		fprintf(f, "Server CPU: %.3f ms per sync step, %.1f%% of one core\n", (double)cpu / steps, duration ? (cpu * 100.0) / duration : 0.0);
+	}
+	else {
+		fprintf(f, "Server CPU: not measured (needs the pid of the server on Linux)\n");
+	}
+
+	// commands
+	uint32 sent = 0, answered = 0, lost = 0;
+	FOR(vector_tpl<sim_client_t*>, const c, clients) {
+		sent += c->sent;
+		answered += c->answered;
+		lost += c->lost;
+	}
+	fprintf(f, "Tool commands: sent %u, answered %u, lost %u\n", sent, answered, lost);
+	if(  !round_trips.empty()  ) {
+		vector_tpl<uint32> sorted(round_trips);
+		std::sort(sorted.begin(), sorted.end());
+		fprintf(f, "Round trip [ms]: median %u, 95%% %u, 99%% %u, max %u\n",
+			get_percentile(sorted, 50), get_percentile(sorted, 95), get_percentile(sorted, 99), sorted.back());
+	}
+
+	// the drift of NWC_CHECK is the difference to the arrival expected from the server frame rate,
+	// clients correct this by frame_timediff
+	double n = 0, mean_step = 0, mean_time = 0;
+	FOR(vector_tpl<sim_client_t*>, const c, clients) {
+		FOR(vector_tpl<check_sample_t>, const &s, c->checks) {
+			n++;
+			mean_step += s.server_sync_step;
+			mean_time += s.time;
+		}
+	}
+	if(  n<2  ) {
+		fprintf(f, "Check drift: not enough NWC_CHECK received\n");
+	}
+	else {
+		mean_step /= n;
+		mean_time /= n;
+		double cov = 0, var = 0;
+		FOR(vector_tpl<sim_client_t*>, const c, clients) {
+			FOR(vector_tpl<check_sample_t>, const &s, c->checks) {
+				cov += (s.server_sync_step - mean_step) * (s.time - mean_time);
+				var += (s.server_sync_step - mean_step) * (s.server_sync_step - mean_step);
+			}
+		}
+		const double ms_per_step = var>0 ? cov / var : 0;
+		double sum_sq = 0;
+		fprintf(f, "Check drift [ms] (late arrivals are positive):\n");
+		FOR(vector_tpl<sim_client_t*>, const c, clients) {
+			if(  c->checks.empty()  ) {
+				continue;
+			}
+			double low = 1e9, high = -1e9, sum = 0;
+			FOR(vector_tpl<check_sample_t>, const &s, c->checks) {
+				const double drift = (s.time - mean_time) - (s.server_sync_step - mean_step) * ms_per_step;
+				low = std::min(low, drift);
+				high = std::max(high, drift);
+				sum += drift;
+				sum_sq += drift * drift;
+			}
+			fprintf(f, "  client %3u: mean %7.1f, min %7.1f, max %7.1f, %u checks\n", c->nr, sum / c->checks.get_count(), low, high, c->checks.get_count());
+		}
+		fprintf(f, "  all clients: rms %.1f\n", sqrt(sum_sq / n));
+	}
+
+	fprintf(f, "\nPer client:\n");
+	FOR(vector_tpl<sim_client_t*>, const c, clients) {
+		fprintf(f, "  client %3u: id %u, join %u ms, sent %u, answered %u, lost %u%s\n",
+			c->nr, c->client_id, c->join_time, c->sent, c->answered, c->lost, c->disconnected ? ", disconnected" : "");
+	}
+}
+
+
+int soak_test(const char *server_address, int argc, char **argv)
+{
+	if(  !is_loopback(server_address)  ) {
+		fprintf(stderr, "The soak test only runs against a server on this machine\n");
+		return 3;
+	}
+	const int count = atoi(argv[0]);
+	const int seconds = atoi(argv[1]);
+	if(  count<=0  ||  count>MAX_CLIENTS  ||  seconds<=0  ) {
+		fprintf(stderr, "Between 1 and %d clients and a positive time are needed\n", MAX_CLIENTS);
+		return 3;
+	}
+	const double rate = argc>3 ? atof(argv[3]) : 0.0;
+	const int pid = argc>4 ? atoi(argv[4]) : 0;
+
+	soak_t soak(server_address, count, rate, pid, false);
+	if(  strcmp(argv[2], "-")!=0  &&  !soak.load_recording(argv[2])  ) {
+		return 3;
+	}
+	soak.run(seconds);
+
+	soak.write_report(stdout);
+	if(  FILE *f = fopen(REPORT_FILE, "w")  ) {
+		soak.write_report(f);
+		fclose(f);
+		printf("\nReport written to " REPORT_FILE "\n");
+	}
+	FOR(vector_tpl<sim_client_t*>, const c, soak.clients) {
+		if(  c->join_time  ) {
+			return 0;
+		}
+	}
+	// server not reachable
+	return 1;
+}
+
+
+int soak_record(const char *server_address, int, char **argv)
+{
+	if(  !is_loopback(server_address)  ) {
+		fprintf(stderr, "Recording only runs against a server on this machine\n");
+		return 3;
+	}
+	const int seconds = atoi(argv[0]);
+	if(  seconds<=0  ) {
+		return 3;
+	}
+
+	soak_t soak(server_address, 1, 0.0, 0, true);
+	soak.run(seconds);
+	if(  soak.record_start==0  ) {
+		fprintf(stderr, "Could not join the server\n");
+		return 1;
+	}
+	if(  !soak.save_recording(argv[1])  ) {
+		return 3;
+	}
+	printf("Recorded %u tool commands to %s\n", soak.tools.get_count(), argv[1]);
+	return 0;
+}
@@ -0,0 +1,30 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef NETTOOLS_SOAK_H
+#define NETTOOLS_SOAK_H
+
+
+/*
+ * Load test of a server on the same machine: simulated clients join the game,
+ * replay recorded tool commands and measure how the server answers.
+ * The simulated clients do not load the game, they only speak the protocol.
+ */
+
+/**
+ * soak <clients> <seconds> <recording> [<commands per second>] [<server pid>]
+ * Writes soak-report.txt and prints it.
+ * @return return code of nettool
+ */
+int soak_test(const char *server_address, int argc, char **argv);
+
+/**
+ * record <seconds> <recording>
+ * Joins as a single client and saves the tool commands of all players.
+ * @return return code of nettool
+ */
+int soak_record(const char *server_address, int argc, char **argv);
+
+#endif
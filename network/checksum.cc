@@ -141,6 +141,13 @@ void checksum_t::input(const char *data)
 }
 
 
+void checksum_t::input(const uint8 *data, uint32 len)
+{
+	assert(sha);
+	sha->Input((const char*)data, len);
+}
+
+
 const char* checksum_t::get_str(const int maxlen) const
 {
 	static char buf[41];
@@ -38,6 +38,7 @@ public:
 	void input(uint32 data);
 	void input(sint32 data);
 	void input(const char *data);
+	void input(const uint8 *data, uint32 len);
 	const char* get_str(const int maxlen=20) const;
 
 	// templated to be able to read/write from/to loadsave_t and packet_t
@@ -0,0 +1,372 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include <string.h>
+
+#include "command_log.h"
+#include "network.h"
+#include "network_packet.h"
+#include "network_cmd_ingame.h"
+
+#include "../simworld.h"
+#include "../simdebug.h"
+#include "../simversion.h"
+#include "../dataobj/environment.h"
+#include "../player/simplay.h"
+#include "../sys/simsys.h"
+#include "../utils/cbuffer_t.h"
+#include "../utils/plainstring.h"
+
+
+#define RECORD_MAGIC "SREC"
+#define RECORD_VERSION (1)
+
+
+FILE *command_log_t::record_file = NULL;
+uint32 command_log_t::record_map_counter = 0;
+bool command_log_t::record_dirty = false;
+bool command_log_t::record_done = false;
+
+uint8 *command_log_t::replay_data = NULL;
+uint32 command_log_t::replay_size = 0;
+uint32 command_log_t::replay_offset = 0;
+bool command_log_t::replay_pending = false;
+uint32 command_log_t::start_sync_step = 0;
+network_world_command_t *command_log_t::next_command = NULL;
+
+uint32 command_log_t::commands_replayed = 0;
+uint32 command_log_t::checks_passed = 0;
+uint32 command_log_t::start_time = 0;
+bool command_log_t::failed = false;
+
+// name of the recording without extension
+static plainstring replay_name;
+
+
+static bool copy_file(const char *source, const char *dest)
+{
+	FILE *in = dr_fopen(source, "rb");
+	if(  in == NULL  ) {
+		return false;
+	}
+	FILE *out = dr_fopen(dest, "wb");
+	if(  out == NULL  ) {
+		fclose(in);
+		return false;
+	}
+	char buf[65536];
+	bool ok = true;
+	size_t len;
+	while(  ok  &&  (len = fread(buf, 1, sizeof(buf), in)) > 0  ) {
+		ok = fwrite(buf, 1, len, out) == len;
+	}
+	fclose(in);
+	return fclose(out) == 0  &&  ok;
+}
+
+
+void command_log_t::step(karte_t *welt)
+{
+	if(  !env_t::server  ||  env_t::server_command_log.empty()  ||  record_done  ) {
+		return;
+	}
+	if(  record_file == NULL  ) {
+		if(  !start_recording(welt)  ) {
+			record_done = true;
+		}
+		return;
+	}
+	if(  welt->get_map_counter() != record_map_counter  ) {
+		// the commands of the new map cannot be replayed on the snapshot
+		dbg->warning("command_log_t::step", "map was reloaded, recording stopped at sync_step=%u", welt->get_sync_steps());
+		stop_recording();
+		return;
+	}
+	if(  record_dirty  ) {
+		// a killed server leaves a complete recording
+		fflush(record_file);
+		record_dirty = false;
+	}
+}
+
+
+bool command_log_t::start_recording(karte_t *welt)
+{
+	dr_chdir( env_t::user_dir );
+
+	// the snapshot is saved like the one of a hot join, see nwc_sync_t::send_snapshot
+	cbuffer_t fn;
+	fn.printf("%s.sve", env_t::server_command_log.c_str());
+	pwd_hash_t pwd_hashes[PLAYER_UNOWNED];
+	for(  int i=0;  i<PLAYER_UNOWNED; i++  ) {
+		if(  player_t *player = welt->get_player(i)  ) {
+			pwd_hashes[i] = player->access_password_hash();
+			player->access_password_hash().clear();
+		}
+	}
+	bool old_restore_UI = env_t::restore_UI;
+	env_t::restore_UI = true;
+	welt->save( fn, false, SERVER_SAVEGAME_VER_NR, EXTENDED_VER_NR, EXTENDED_REVISION_NR, false );
+	env_t::restore_UI = old_restore_UI;
+	for(  int i=0;  i<PLAYER_UNOWNED; i++  ) {
+		if(  player_t *player = welt->get_player(i)  ) {
+			player->access_password_hash() = pwd_hashes[i];
+		}
+	}
+
+	fn.clear();
+	fn.printf("%s.rec", env_t::server_command_log.c_str());
+	record_file = dr_fopen(fn, "wb");
+	if(  record_file == NULL  ) {
+		dbg->warning("command_log_t::start_recording", "cannot write %s", (const char *)fn);
+		return false;
+	}
+
+	uint32 sync_step = welt->get_sync_steps();
+	record_map_counter = welt->get_map_counter();
+	checklist_t checklist = welt->get_checklist_at(sync_step);
+
+	uint8 buf[512];
+	memory_rw_t header(buf, sizeof(buf), true);
+	uint8 magic[4];
+	memcpy(magic, RECORD_MAGIC, 4);
+	header.rdwr_bytes(magic, 4);
+	uint16 version = RECORD_VERSION;
+	header.rdwr_short(version);
+	header.rdwr_long(sync_step);
+	header.rdwr_long(record_map_counter);
+	checklist.rdwr(&header);
+	fwrite(buf, 1, header.get_current_index(), record_file);
+
+	// the same commands a joining client receives with the snapshot
+	write_packet( nwc_routesearch_t::pack_active_limit_set(sync_step, record_map_counter) );
+	FOR(slist_tpl<network_world_command_t*>, const nwc, welt->get_command_queue()) {
+		write_packet( nwc->copy_packet() );
+	}
+	FOR(slist_tpl<network_command_t*>, const nwc, network_get_received_commands()) {
+		if(  dynamic_cast<network_world_command_t *>(nwc)  ) {
+			write_packet( nwc->copy_packet() );
+		}
+	}
+	dbg->message("command_log_t::start_recording", "recording commands from sync_step=%u to %s", sync_step, (const char *)fn);
+	return true;
+}
+
+
+void command_log_t::stop_recording()
+{
+	if(  record_file  ) {
+		fclose(record_file);
+		record_file = NULL;
+	}
+	record_done = true;
+}
+
+
+void command_log_t::record(network_command_t *nwc)
+{
+	if(  record_file == NULL  ) {
+		return;
+	}
+	network_world_command_t *nwwc = dynamic_cast<network_world_command_t *>(nwc);
+	// steps carry no action and syncs of other maps end the recording anyway
+	if(  nwwc  &&  nwc->get_id() != NWC_STEP  &&  nwc->get_id() != NWC_SYNC  &&  nwwc->get_map_counter() == record_map_counter  ) {
+		write_packet( nwc->copy_packet() );
+	}
+}
+
+
+void command_log_t::write_packet(packet_t *p)
+{
+	p->write_header();
+	if(  fwrite(p->get_data(), 1, p->get_size(), record_file) != p->get_size()  ) {
+		dbg->warning("command_log_t::write_packet", "cannot write recording, stopped");
+		stop_recording();
+	}
+	record_dirty = true;
+	delete p;
+}
+
+
+bool command_log_t::init_replay(const char *name)
+{
+	cbuffer_t fn;
+	fn.printf("%s.rec", name);
+	FILE *f = dr_fopen(fn, "rb");
+	if(  f == NULL  ) {
+		dbg->warning("command_log_t::init_replay", "cannot open %s", (const char *)fn);
+		return false;
+	}
+	fseek(f, 0, SEEK_END);
+	const long len = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	replay_data = len > 0 ? (uint8 *)malloc(len) : NULL;
+	const bool ok = replay_data  &&  fread(replay_data, 1, len, f) == (size_t)len  &&  len > 6  &&  memcmp(replay_data, RECORD_MAGIC, 4) == 0;
+	fclose(f);
+	if(  !ok  ||  (replay_data[4] | (replay_data[5] << 8)) != RECORD_VERSION  ) {
+		dbg->warning("command_log_t::init_replay", "%s is not a recording of this version", (const char *)fn);
+		free(replay_data);
+		replay_data = NULL;
+		return false;
+	}
+	replay_size = len;
+	replay_name = name;
+	replay_pending = true;
+	failed = false;
+	return true;
+}
+
+
+void command_log_t::start_replay(karte_t *welt)
+{
+	if(  !replay_pending  ) {
+		return;
+	}
+	replay_pending = false;
+
+	memory_rw_t header(replay_data, replay_size, false);
+	uint8 magic[4];
+	header.rdwr_bytes(magic, 4);
+	uint16 version;
+	header.rdwr_short(version);
+	uint32 map_counter;
+	checklist_t checklist;
+	header.rdwr_long(start_sync_step);
+	header.rdwr_long(map_counter);
+	checklist.rdwr(&header);
+	replay_offset = header.get_current_index();
+
+	// load the snapshot like a joining client, see nwc_sync_t::do_command
+	dr_chdir( env_t::user_dir );
+	cbuffer_t snapshot, fn;
+	snapshot.printf("%s.sve", replay_name.c_str());
+	fn.printf("client%i-network.sve", network_get_client_id());
+	if(  !copy_file(snapshot, fn)  ) {
+		finish_replay(welt, "cannot read the snapshot");
+		return;
+	}
+	env_t::networkmode = true;
+	if(  !welt->load(fn)  ) {
+		finish_replay(welt, "cannot load the snapshot");
+		return;
+	}
+	welt->set_map_counter(map_counter);
+	welt->network_game_set_pause(false, start_sync_step);
+	welt->set_checklist_at(start_sync_step, checklist);
+
+	commands_replayed = 0;
+	checks_passed = 0;
+	start_time = dr_time();
+	dbg->message("command_log_t::start_replay", "replaying %s from sync_step=%u", replay_name.c_str(), start_sync_step);
+}
+
+
+network_world_command_t *command_log_t::read_command()
+{
+	while(  replay_offset + HEADER_SIZE <= replay_size  ) {
+		uint16 size;
+		memory_rw_t len(replay_data + replay_offset, 2, false);
+		len.rdwr_short(size);
+		if(  size < HEADER_SIZE  ||  replay_offset + size > replay_size  ) {
+			break;
+		}
+		packet_t *p = new packet_t(replay_data + replay_offset, size);
+		replay_offset += size;
+		network_command_t *nwc = network_command_t::read_from_packet(p);
+		if(  network_world_command_t *nwwc = dynamic_cast<network_world_command_t *>(nwc)  ) {
+			return nwwc;
+		}
+		dbg->warning("command_log_t::read_command", "skipping invalid command at offset %u", replay_offset - size);
+		delete nwc;
+	}
+	if(  replay_offset < replay_size  ) {
+		// the server was killed while writing
+		dbg->warning("command_log_t::read_command", "recording truncated at offset %u", replay_offset);
+		replay_offset = replay_size;
+	}
+	return NULL;
+}
+
+
+void command_log_t::replay(karte_t *welt)
+{
+	if(  !env_t::networkmode  ) {
+		// karte_t::network_disconnect() was called, e.g. a tool of the recording found a checklist mismatch
+		finish_replay(welt, "lost synchronisation");
+		return;
+	}
+
+	// hand over the commands like they were received from the server
+	const uint32 sync_steps = welt->get_sync_steps();
+	while(  true  ) {
+		if(  next_command == NULL  &&  (next_command = read_command()) == NULL  ) {
+			break;
+		}
+		if(  next_command->get_sync_step() > sync_steps + 1  ) {
+			break;
+		}
+		network_world_command_t *nwc = next_command;
+		next_command = NULL;
+
+		if(  nwc->get_id() == NWC_CHECK  ) {
+			// the checkpoints of the server
+			const nwc_check_t *check = static_cast<nwc_check_t *>(nwc);
+			if(  welt->is_checklist_available(check->server_sync_step)  ) {
+				const checklist_t &own = welt->get_checklist_at(check->server_sync_step);
+				if(  own != check->server_checklist  ) {
+					char buf[2048];
+					const int offset = check->server_checklist.print(buf, "server");
+					own.print(buf + offset, "replay");
+					dbg->warning("command_log_t::replay", "checklist mismatch at sync_step=%u %s", check->server_sync_step, buf);
+					delete nwc;
+					finish_replay(welt, "checklist mismatch");
+					return;
+				}
+				checks_passed++;
+			}
+			delete nwc;
+			continue;
+		}
+
+		commands_replayed++;
+		if(  nwc->execute(welt)  ) {
+			delete nwc;
+		}
+	}
+
+	welt->process_command_queue();
+
+	if(  next_command == NULL  &&  welt->get_command_queue().empty()  &&  env_t::networkmode  ) {
+		finish_replay(welt, NULL);
+	}
+}
+
+
+void command_log_t::finish_replay(karte_t *welt, const char *error)
+{
+	uint32 ms = dr_time() - start_time;
+	if(  ms == 0  ) {
+		ms = 1;
+	}
+	const uint32 sync_steps = welt->get_sync_steps() - start_sync_step;
+	if(  error  ) {
+		failed = true;
+		dbg->warning("command_log_t::finish_replay", "replay of %s failed at sync_step=%u: %s", replay_name.c_str(), welt->get_sync_steps(), error);
+		printf("Replay of %s FAILED at sync step %u: %s\n", replay_name.c_str(), welt->get_sync_steps(), error);
+	}
+	else {
+		dbg->message("command_log_t::finish_replay", "replay of %s passed", replay_name.c_str());
+		printf("Replay of %s passed\n", replay_name.c_str());
+	}
+	printf("%u sync steps, %u commands, %u checklists compared in %u ms (%.1f sync steps per second)\n",
+		sync_steps, commands_replayed, checks_passed, ms, sync_steps * 1000.0 / ms);
+
+	delete next_command;
+	next_command = NULL;
+	free(replay_data);
+	replay_data = NULL;
+	network_core_shutdown();
+	welt->stop(true);
+}
@@ -0,0 +1,92 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef NETWORK_COMMAND_LOG_H
+#define NETWORK_COMMAND_LOG_H
+
+
+#include <stdio.h>
+
+#include "../simtypes.h"
+
+class karte_t;
+class network_command_t;
+class network_world_command_t;
+class packet_t;
+
+
+/**
+ * Records the world commands of a server game and replays them without network,
+ * to check that a change of the code did not alter the simulation and to measure its speed.
+ *
+ * If server_command_log is set, the server saves a snapshot as <name>.sve after the first
+ * sync step and then writes every world command it sends to <name>.rec, including the
+ * nwc_check_t with the checklist of the server. The snapshot is taken like the one of a
+ * hot join, so the recording stops when the server reloads the map (full join, new game).
+ *
+ * With -replay <name> the game loads the snapshot like a joining client, executes the
+ * commands at their sync steps as fast as possible and compares the checklists.
+ */
+class command_log_t
+{
+public:
+	/// server: called after every sync step in network games, starts the recording if due
+	static void step(karte_t *welt);
+
+	/// server: writes a command sent to the clients to the recording
+	static void record(network_command_t *nwc);
+
+	/// server: finishes the recording
+	static void stop_recording();
+
+	/// reads <name>.rec, the replay starts with the next call of karte_t::interactive()
+	static bool init_replay(const char *name);
+
+	/// loads the snapshot of the recording if a replay is pending
+	static void start_replay(karte_t *welt);
+
+	static bool is_replaying() { return replay_data != NULL  &&  !replay_pending; }
+
+	/// executes the recorded commands that are due, called instead of karte_t::process_network_commands()
+	static void replay(karte_t *welt);
+
+	/// @return true if a replay did not reach the end of the recording with matching checklists
+	static bool replay_failed() { return failed; }
+
+private:
+	/// the recording
+	static FILE *record_file;
+	static uint32 record_map_counter;
+	static bool record_dirty;
+	/// recording ended (map reloaded), it will not start again
+	static bool record_done;
+
+	/// the replay
+	static uint8 *replay_data;
+	static uint32 replay_size;
+	static uint32 replay_offset;
+	static bool replay_pending;
+	static uint32 start_sync_step;
+	/// next command, held back until it is due
+	static network_world_command_t *next_command;
+
+	static uint32 commands_replayed;
+	static uint32 checks_passed;
+	static uint32 start_time;
+	static bool failed;
+
+	static bool start_recording(karte_t *welt);
+
+	/// writes the packet to the recording and deletes it
+	static void write_packet(packet_t *p);
+
+	/// @return the next command of the recording or NULL at its end
+	static network_world_command_t *read_command();
+
+	/// ends the replay, prints the result and quits
+	static void finish_replay(karte_t *welt, const char *error);
+};
+
+#endif
@@ -23,6 +23,8 @@
 #include "../simversion.h"
 
 #ifndef NETTOOL
+#include "network_file_transfer.h"
+#include "command_log.h"
 #include "../dataobj/environment.h"
 #endif
 
@@ -56,6 +58,20 @@ void clear_command_queue()
 #define RET_ERR_STR { err = err_str; return INVALID_SOCKET; }
 
 #include <signal.h>
+#include <sys/uio.h>
+#endif
+
+#if USE_EPOLL
+#include <sys/epoll.h>
+
+// all sockets of the socket list, waiting for input
+static int epoll_fd = -1;
+
+// sockets with a full send buffer, waiting until they can be written
+static int epoll_write_fd = -1;
+static vector_tpl<SOCKET> write_waiting;
+
+#define MAX_EPOLL_EVENTS (64)
 #endif
 
 
@@ -488,12 +504,137 @@ network_command_t* network_get_received_command()
 }
 
 
+const slist_tpl<network_command_t *> &network_get_received_commands()
+{
+	return received_command_queue;
+}
+
+
+void network_prepend_received_commands(slist_tpl<network_command_t *> &commands)
+{
+	commands.append_list(received_command_queue);
+	received_command_queue.append_list(commands);
+}
+
+
+#if USE_EPOLL
+static void network_poll_init()
+{
+	if(  epoll_fd<0  ) {
+		epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+		epoll_write_fd = epoll_create1(EPOLL_CLOEXEC);
+		if(  epoll_fd<0  ||  epoll_write_fd<0  ) {
+			dbg->fatal("network_poll_init", "could not create epoll instance: %s", strerror(errno));
+		}
+	}
+}
+
+
+// the index in the socket list is kept with the socket, sockets are never moved while registered
+static void network_poll_ctl(int fd, int op, SOCKET sock, uint32 index, uint32 events)
+{
+	struct epoll_event ev;
+	ev.events = events;
+	ev.data.u64 = ((uint64)index << 32) | (uint32)sock;
+	if(  epoll_ctl(fd, op, sock, &ev)!=0  &&  op==EPOLL_CTL_ADD  &&  errno==EEXIST  ) {
+		// already registered, maybe at another index
+		epoll_ctl(fd, EPOLL_CTL_MOD, sock, &ev);
+	}
+}
+
+
+// @return the index of the socket from an event, or -1 if it was closed in the meantime
+static sint32 network_poll_get_index(const struct epoll_event &ev, SOCKET &sock)
+{
+	const uint32 index = (uint32)(ev.data.u64 >> 32);
+	sock = (SOCKET)(ev.data.u64 & 0xFFFFFFFFu);
+	if(  socket_list_t::is_valid_client_id(index)  &&  socket_list_t::get_client(index).socket==sock  ) {
+		return index;
+	}
+	return socket_list_t::has_client(sock) ? (sint32)socket_list_t::get_client_id(sock) : -1;
+}
+#endif
+
+
+void network_poll_add(SOCKET sock, uint32 index)
+{
+#if USE_EPOLL
+	network_poll_init();
+	network_poll_ctl(epoll_fd, EPOLL_CTL_ADD, sock, index, EPOLLIN);
+#else
+	(void)sock;
+	(void)index;
+#endif
+}
+
+
+// server: accept a new connection
+static void network_accept(SOCKET accept_sock)
+{
+	struct sockaddr_in client_name;
+	socklen_t size = sizeof(client_name);
+	SOCKET s = accept(accept_sock, (struct sockaddr *)&client_name, &size);
+	if (s != INVALID_SOCKET) {
+#if USE_WINSOCK
+		uint32 ip = ntohl((uint32)client_name.sin_addr.S_un.S_addr);
+#else
+		uint32 ip = ntohl((uint32)client_name.sin_addr.s_addr);
+#endif
+		if (blacklist.contains(net_address_t(ip))) {
+			// refuse connection
+			network_close_socket(s);
+			return;
+		}
+#ifdef  __BEOS__
+		char name[256];
+		sprintf(name, "%lh", client_name.sin_addr.s_addr);
+#else
+		const char *name = inet_ntoa(client_name.sin_addr);
+#endif
+		dbg->message("check_activity()", "Accepted connection from: %s.", name);
+		socket_list_t::add_client(s, ip);
+	}
+}
+
+
+// all: continue receiving from a client
+static void network_receive_from(SOCKET sender, uint32 client_id)
+{
+	network_command_t *nwc = socket_list_t::get_client(client_id).receive_nwc();
+	if (nwc) {
+		received_command_queue.append(nwc);
+		dbg->message("network_check_activity()", "received cmd id=%d %s from socket[%d]", nwc->get_id(), nwc->get_name(), sender);
+	}
+	// errors are caught and treated in socket_info_t::receive_nwc
+}
+
+
 /* do appropriate action for network games:
 * - server: accept connection to a new client
 * - all: receive commands and puts them to the received_command_queue
 */
 network_command_t* network_check_activity(karte_t *, int timeout)
 {
+#if USE_EPOLL
+	network_poll_init();
+	struct epoll_event events[MAX_EPOLL_EVENTS];
+	const int action = epoll_wait(epoll_fd, events, MAX_EPOLL_EVENTS, timeout);
+	for(  int i=0;  i<action;  i++  ) {
+		SOCKET sock;
+		const sint32 index = network_poll_get_index(events[i], sock);
+		if(  index<0  ) {
+			// closed while handling an earlier event
+			continue;
+		}
+		if(  socket_list_t::get_client(index).state==socket_info_t::server  ) {
+			network_accept(sock);
+		}
+		else {
+			network_receive_from(sock, index);
+		}
+	}
+	return network_get_received_command();
+#else
 	fd_set fds;
 	FD_ZERO(&fds);
 
@@ -516,29 +657,7 @@ network_command_t* network_check_activity(karte_t *, int timeout)
 		SOCKET accept_sock = iter_s.get_current();
 
 		if (accept_sock != INVALID_SOCKET) {
-			struct sockaddr_in client_name;
-			socklen_t size = sizeof(client_name);
-			SOCKET s = accept(accept_sock, (struct sockaddr *)&client_name, &size);
-			if (s != INVALID_SOCKET) {
-#if USE_WINSOCK
-				uint32 ip = ntohl((uint32)client_name.sin_addr.S_un.S_addr);
-#else
-				uint32 ip = ntohl((uint32)client_name.sin_addr.s_addr);
-#endif
-				if (blacklist.contains(net_address_t(ip))) {
-					// refuse connection
-					network_close_socket(s);
-					continue;
-				}
-#ifdef  __BEOS__
-				char name[256];
-				sprintf(name, "%lh", client_name.sin_addr.s_addr);
-#else
-				const char *name = inet_ntoa(client_name.sin_addr);
-#endif
-				dbg->message("check_activity()", "Accepted connection from: %s.", name);
-				socket_list_t::add_client(s, ip);
-			}
+			network_accept(accept_sock);
 		}
 	}
 
@@ -548,21 +667,63 @@ network_command_t* network_check_activity(karte_t *, int timeout)
 		SOCKET sender = iter_c.get_current();
 
 		if (sender != INVALID_SOCKET  &&  socket_list_t::has_client(sender)) {
-			uint32 client_id = socket_list_t::get_client_id(sender);
-			network_command_t *nwc = socket_list_t::get_client(client_id).receive_nwc();
-			if (nwc) {
-				received_command_queue.append(nwc);
-				dbg->message("network_check_activity()", "received cmd id=%d %s from socket[%d]", nwc->get_id(), nwc->get_name(), sender);
-			}
-			// errors are caught and treated in socket_info_t::receive_nwc
+			network_receive_from(sender, socket_list_t::get_client_id(sender));
 		}
 	}
 	return network_get_received_command();
+#endif
 }
 
 
 void network_process_send_queues(int timeout)
 {
+#ifndef NETTOOL
+	// refill the send queues of clients receiving a game
+	network_process_file_transfers();
+#endif
+
+#if USE_EPOLL
+	network_poll_init();
+	// send right away, usually everything fits into the socket buffers
+	bool has_clients = false;
+	for(  uint32 i=socket_list_t::get_server_sockets();  i<socket_list_t::get_count();  i++  ) {
+		socket_info_t &info = socket_list_t::get_client(i);
+		if(  !info.is_active()  ||  info.socket==INVALID_SOCKET  ) {
+			continue;
+		}
+		has_clients = true;
+		if(  info.get_send_queue_count()>0  ) {
+			const SOCKET sock = info.socket;
+			info.process_send_queue();
+			// errors are caught and treated in socket_info_t::process_send_queue
+			if(  info.socket==sock  &&  info.get_send_queue_count()>0  &&  !write_waiting.is_contained(sock)  ) {
+				network_poll_ctl(epoll_write_fd, EPOLL_CTL_ADD, sock, i, EPOLLOUT);
+				write_waiting.append(sock);
+			}
+		}
+	}
+
+	// like select: wait only if some socket is blocked or there is none at all
+	if(  !write_waiting.empty()  ||  !has_clients  ) {
+		struct epoll_event events[MAX_EPOLL_EVENTS];
+		const int action = epoll_wait(epoll_write_fd, events, MAX_EPOLL_EVENTS, timeout);
+		for(  int i=0;  i<action;  i++  ) {
+			SOCKET sock;
+			const sint32 index = network_poll_get_index(events[i], sock);
+			if(  index>=0  ) {
+				socket_list_t::get_client(index).process_send_queue();
+			}
+		}
+		// stop waiting for sockets with empty queues
+		for(  uint32 i=write_waiting.get_count();  i-->0;  ) {
+			const SOCKET sock = write_waiting[i];
+			if(  !socket_list_t::has_client(sock)  ||  socket_list_t::get_client(socket_list_t::get_client_id(sock)).get_send_queue_count()==0  ) {
+				epoll_ctl(epoll_write_fd, EPOLL_CTL_DEL, sock, NULL);
+				write_waiting.remove_at(i);
+			}
+		}
+	}
+#else
 	fd_set fds;
 	FD_ZERO(&fds);
 
@@ -592,6 +753,7 @@ void network_process_send_queues(int timeout)
 		}
 		action--;
 	}
+#endif
 }
 
 
@@ -630,9 +792,15 @@ void network_send_all(network_command_t* nwc, bool exclude_us)
 {
 	if (nwc) {
 		nwc->prepare_to_send();
+#ifndef NETTOOL
+		command_log_t::record(nwc);
+#endif
 		socket_list_t::send_all(nwc, true);
 		if (!exclude_us  &&  network_server_port) {
 			// I am the server
+#ifndef NETTOOL
+			nwc_sync_t::log_command(nwc);
+#endif
 			nwc->get_packet()->sent_by_server();
 			received_command_queue.append(nwc);
 		}
@@ -724,6 +892,59 @@ bool network_send_data(SOCKET dest, const char *buf, const uint16 size, uint16 &
 }
 
 
+bool network_send_buffers(SOCKET dest, const network_buffer_t *buffers, uint32 count, uint32 &sent)
+{
+	sent = 0;
+	count = min(count, MAX_SEND_BUFFERS);
+#if USE_WINSOCK
+	WSABUF bufs[MAX_SEND_BUFFERS];
+	for(  uint32 i=0;  i<count;  i++  ) {
+		bufs[i].buf = (CHAR *)buffers[i].data;
+		bufs[i].len = buffers[i].len;
+	}
+	DWORD bytes = 0;
+	// winsock has no MSG_DONTWAIT, so the socket is non-blocking only during this call
+	u_long non_blocking = 1;
+	ioctlsocket(dest, FIONBIO, &non_blocking);
+	const int res = WSASend(dest, bufs, count, &bytes, 0, NULL, NULL);
+	const int send_err = GET_LAST_ERROR();
+	non_blocking = 0;
+	ioctlsocket(dest, FIONBIO, &non_blocking);
+	if(  res!=0  ) {
+		WSASetLastError(send_err);
+#else
+	struct iovec iov[MAX_SEND_BUFFERS];
+	for(  uint32 i=0;  i<count;  i++  ) {
+		iov[i].iov_base = const_cast<uint8 *>(buffers[i].data);
+		iov[i].iov_len = buffers[i].len;
+	}
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = iov;
+	msg.msg_iovlen = count;
+	int flags = MSG_DONTWAIT;
+#ifdef MSG_NOSIGNAL
+	flags |= MSG_NOSIGNAL;
+#else
+	// ignore SIGPIPE sent by sendmsg() function.
+	signal(SIGPIPE, SIG_IGN);
+#endif
+	const ssize_t bytes = sendmsg(dest, &msg, flags);
+	if(  bytes<0  ) {
+#endif
+		int err = GET_LAST_ERROR();
+		if(  err!=EWOULDBLOCK  &&  err!=EINTR  ) {
+			dbg->warning("network_send_buffers", "error \"%s\" while sending to [%d]", strerror(err), dest);
+			return false;
+		}
+		// continue sending later
+		return true;
+	}
+	sent = (uint32)bytes;
+	return true;
+}
+
+
 /**
 * receive data from sender
 * @param dest the destination buffer
@@ -737,18 +958,28 @@ bool network_receive_data(SOCKET sender, void *dest, const uint16 len, uint16 &r
 	char *ptr = (char *)dest;
 
 	do {
-		fd_set fds;
-		FD_ZERO(&fds);
-		FD_SET(sender, &fds);
-		struct timeval tv;
-		tv.tv_sec = timeout_ms / 1000;
-		tv.tv_usec = (timeout_ms % 1000) * 1000ul;
-		// can we read?
-		if (select(FD_SETSIZE, &fds, NULL, NULL, &tv) != 1) {
-			return true;
+		int flags = 0;
+#if USE_EPOLL
+		if (timeout_ms <= 0) {
+			// epoll reported the socket readable, no need to ask select again
+			flags = MSG_DONTWAIT;
+		}
+		else
+#endif
+		{
+			fd_set fds;
+			FD_ZERO(&fds);
+			FD_SET(sender, &fds);
+			struct timeval tv;
+			tv.tv_sec = timeout_ms / 1000;
+			tv.tv_usec = (timeout_ms % 1000) * 1000ul;
+			// can we read?
+			if (select(FD_SETSIZE, &fds, NULL, NULL, &tv) != 1) {
+				return true;
+			}
 		}
 		// now receive
-		int res = recv(sender, ptr + received, len - received, 0);
+		int res = recv(sender, ptr + received, len - received, flags);
 		if (res == -1) {
 			int err = GET_LAST_ERROR();
 			if (err != EWOULDBLOCK) {
@@ -773,6 +1004,15 @@ bool network_receive_data(SOCKET sender, void *dest, const uint16 len, uint16 &r
 void network_close_socket(SOCKET sock)
 {
 	if (sock != INVALID_SOCKET) {
+#if USE_EPOLL
+		// closing would unregister the socket too, but only if it was never duplicated
+		if (epoll_fd >= 0) {
+			epoll_ctl(epoll_fd, EPOLL_CTL_DEL, sock, NULL);
+			if (write_waiting.remove(sock)) {
+				epoll_ctl(epoll_write_fd, EPOLL_CTL_DEL, sock, NULL);
+			}
+		}
+#endif
 #if USE_WINSOCK || defined __BEOS__
 		closesocket(sock);
 #else
@@ -812,6 +1052,15 @@ void network_core_shutdown()
 
 	socket_list_t::reset();
 
+#if USE_EPOLL
+	if (epoll_fd >= 0) {
+		close(epoll_fd);
+		close(epoll_write_fd);
+		epoll_fd = -1;
+		epoll_write_fd = -1;
+	}
+#endif
+
 	if (network_active) {
 #if USE_WINSOCK
 		WSACleanup();
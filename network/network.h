@@ -13,6 +13,13 @@
 #define USE_WINSOCK 0
 #endif
 
+// linux: wait for sockets with epoll, which does not scan all sockets every frame like select
+#if defined(__linux__)  &&  !defined(USE_SELECT)
+#define USE_EPOLL 1
+#else
+#define USE_EPOLL 0
+#endif
+
 // windows headers
 #if USE_WINSOCK
 // must be include before all simutrans stuff!
@@ -63,8 +70,9 @@ typedef int SOCKET;
 
 #include "../simtypes.h"
 #include "../utils/cbuffer_t.h"
+#include "../tpl/slist_tpl.h"
 // version of network protocol code
-#define NETWORK_VERSION (1)
+#define NETWORK_VERSION (2)
 
 class network_command_t;
 class gameinfo_t;
@@ -74,6 +82,12 @@ void network_close_socket(SOCKET sock);
 
 void network_set_socket_nodelay(SOCKET sock);
 
+/**
+* registers a socket of the socket list at @p index for network_check_activity (only needed for epoll)
+* network_close_socket unregisters it again
+*/
+void network_poll_add(SOCKET sock, uint32 index);
+
 // open a socket or give a decent error message
 SOCKET network_open_address(char const* cp, char const*& err);
 
@@ -85,6 +99,18 @@ bool network_init_server(int port);
 */
 network_command_t* network_get_received_command();
 
+/**
+* commands received but not processed yet
+*/
+const slist_tpl<network_command_t *> &network_get_received_commands();
+
+/**
+* puts @p commands in front of the received commands,
+* i.e. the next calls of network_get_received_command return them first
+* @p commands is empty afterwards
+*/
+void network_prepend_received_commands(slist_tpl<network_command_t *> &commands);
+
 /**
 * do appropriate action for network games:
 * - server: accept connection to a new client
@@ -121,6 +147,22 @@ bool network_send_data(SOCKET dest, const char *buf, const uint16 size, uint16 &
 */
 bool network_receive_data(SOCKET sender, void *dest, const uint16 len, uint16 &received, const int timeout_ms);
 
+// most buffers sent with one call of network_send_buffers
+#define MAX_SEND_BUFFERS (16)
+
+struct network_buffer_t
+{
+	const uint8 *data;
+	uint32 len;
+};
+
+/**
+* send several buffers to dest with one system call (writev), without blocking
+* @param sent number of bytes sent, less than all if the socket buffer is full
+* @return true if connection is still open and sending can be continued later
+*/
+bool network_send_buffers(SOCKET dest, const network_buffer_t *buffers, uint32 count, uint32 &sent);
+
 void network_process_send_queues(int timeout);
 
 // true, if I can write on the server connection
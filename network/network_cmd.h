@@ -39,6 +39,8 @@ enum {
 	NWC_SCENARIO_RULES,
 	NWC_STEP,
 	NWC_ROUTESEARCH,
+	NWC_GAME_CHUNK,
+	NWC_STATE_HASH,
 	NWC_COUNT
 };
 
@@ -10,6 +10,7 @@
 #include "network_socket_list.h"
 #include "network_cmp_pakset.h"
 #include "network_cmd_scenario.h"
+#include "state_hash.h"
 
 #include "../dataobj/loadsave.h"
 #include "../dataobj/gameinfo.h"
@@ -27,6 +28,11 @@
 #include "../utils/csv.h"
 #include "../display/viewport.h"
 
+#include <zlib.h>
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
 
 network_command_t* network_command_t::read_from_packet(packet_t *p)
 {
@@ -44,6 +50,8 @@ network_command_t* network_command_t::read_from_packet(packet_t *p)
 		case NWC_JOIN:        nwc = new nwc_join_t(); break;
 		case NWC_SYNC:        nwc = new nwc_sync_t(); break;
 		case NWC_GAME:        nwc = new nwc_game_t(); break;
+		case NWC_GAME_CHUNK:  nwc = new nwc_game_chunk_t(); break;
+		case NWC_STATE_HASH:  nwc = new nwc_state_hash_t(); break;
 		case NWC_READY:       nwc = new nwc_ready_t(); break;
 		case NWC_TOOL:        nwc = new nwc_tool_t(); break;
 		case NWC_CHECK:       nwc = new nwc_check_t(); break;
@@ -399,6 +407,12 @@ void nwc_join_t::rdwr()
 	nwc_nick_t::rdwr();
 	packet->rdwr_long(client_id);
 	packet->rdwr_byte(answer);
+	// version 1 clients receive the game uncompressed in one piece
+	if(  packet->get_version() >= 2  ) {
+		packet->rdwr_byte(compression);
+		packet->rdwr_long(resume_offset);
+		resume_checksum.rdwr(packet);
+	}
 }
 
 
@@ -419,19 +433,33 @@ bool nwc_join_t::execute(karte_t *welt)
 
 		// no other joining process active?
 		nwj.answer = socket_list_t::get_client(nwj.client_id).is_active()  &&  pending_join_client == INVALID_SOCKET ? 1 : 0;
+		// the game is only sent in chunks, which older clients cannot receive
+		if(  packet->get_version() < 2  ) {
+			dbg->warning("nwc_join_t::execute", "client %d uses network version %d", nwj.client_id, packet->get_version());
+			nwj.answer = 0;
+		}
 		DBG_MESSAGE( "nwc_join_t::execute", "client_id=%i active=%i pending_join_client=%i active=%d", socket_list_t::get_client_id(packet->get_sender()), socket_list_t::get_client(nwj.client_id).is_active(), pending_join_client, nwj.answer );
 		nwj.rdwr();
 		if(  nwj.send( packet->get_sender() )  ) {
 			if(  nwj.answer==1  ) {
 				// now send sync command
-				const uint32 new_map_counter = welt->generate_new_map_counter();
+				// on hot join the world is not reloaded, hence it keeps its map counter
+				const bool hot_join = env_t::server_hot_join;
+				const uint32 new_map_counter = hot_join ? welt->get_map_counter() : welt->generate_new_map_counter();
 				// since network_send_all() does not include non-playing clients -> send sync command separately to the joining client
 				nwc_sync_t nw_sync(welt->get_sync_steps() + 1, welt->get_map_counter(), nwj.client_id, new_map_counter);
 				nw_sync.rdwr();
 				if(  nw_sync.send( packet->get_sender() )  ) {
-					// now send sync command to the server and the remaining clients
-					nwc_sync_t *nws = new nwc_sync_t(welt->get_sync_steps() + 1, welt->get_map_counter(), nwj.client_id, new_map_counter);
-					network_send_all(nws, false);
+					nwc_sync_t *nws = new nwc_sync_t(welt->get_sync_steps() + 1, welt->get_map_counter(), nwj.client_id, new_map_counter, hot_join);
+					nws->set_transfer( min(compression, nwc_game_chunk_t::get_best_compression()), resume_offset, resume_checksum );
+					if(  hot_join  ) {
+						// only the server has to take the snapshot
+						network_send_server(nws);
+					}
+					else {
+						// now send sync command to the server and the remaining clients
+						network_send_all(nws, false);
+					}
 					pending_join_client = packet->get_sender();
 					DBG_MESSAGE( "nwc_join_t::execute", "pending_join_client now %i", pending_join_client);
 					// unpause world
@@ -531,6 +559,109 @@ void nwc_game_t::rdwr()
 {
 	network_command_t::rdwr();
 	packet->rdwr_long(len);
+	packet->rdwr_long(offset);
+	checksum.rdwr(packet);
+}
+
+
+void nwc_game_chunk_t::rdwr()
+{
+	network_command_t::rdwr();
+	packet->rdwr_long(offset);
+	packet->rdwr_short(len);
+	packet->rdwr_byte(method);
+	packet->rdwr_short(size);
+	if(  size > CHUNK_SIZE  ) {
+		packet->failed();
+		return;
+	}
+	packet->rdwr_bytes(data, size);
+	checksum.rdwr(packet);
+}
+
+
+void nwc_game_chunk_t::pack(const uint8 *raw, uint16 raw_len, uint8 compression)
+{
+	assert(raw_len <= CHUNK_SIZE);
+	len = raw_len;
+	checksum.reset();
+	checksum.input(raw, raw_len);
+	checksum.finish();
+
+	if(  compression == ZLIB  ) {
+		uLongf dest_len = CHUNK_SIZE;
+		if(  compress2(data, &dest_len, raw, raw_len, Z_BEST_SPEED) == Z_OK  &&  dest_len < raw_len  ) {
+			method = ZLIB;
+			size = (uint16)dest_len;
+			return;
+		}
+	}
+#ifdef USE_ZSTD
+	else if(  compression == ZSTD  ) {
+		const size_t dest_len = ZSTD_compress(data, CHUNK_SIZE, raw, raw_len, 1);
+		if(  !ZSTD_isError(dest_len)  &&  dest_len < raw_len  ) {
+			method = ZSTD;
+			size = (uint16)dest_len;
+			return;
+		}
+	}
+#endif
+	// not compressible
+	method = RAW;
+	size = raw_len;
+	memcpy(data, raw, raw_len);
+}
+
+
+uint16 nwc_game_chunk_t::unpack(uint8 *dest, uint16 dest_size) const
+{
+	if(  len > dest_size  ) {
+		return 0;
+	}
+	size_t unpacked = 0;
+	switch(  method  ) {
+		case RAW:
+			if(  size == len  ) {
+				memcpy(dest, data, size);
+				unpacked = size;
+			}
+			break;
+		case ZLIB: {
+			uLongf dest_len = dest_size;
+			if(  uncompress(dest, &dest_len, data, size) == Z_OK  ) {
+				unpacked = dest_len;
+			}
+			break;
+		}
+#ifdef USE_ZSTD
+		case ZSTD: {
+			const size_t dest_len = ZSTD_decompress(dest, dest_size, data, size);
+			if(  !ZSTD_isError(dest_len)  ) {
+				unpacked = dest_len;
+			}
+			break;
+		}
+#endif
+		default:
+			dbg->warning("nwc_game_chunk_t::unpack", "unknown compression %d", method);
+	}
+	if(  unpacked != len  ) {
+		return 0;
+	}
+	checksum_t check;
+	check.input(dest, len);
+	check.finish();
+	return check == checksum ? len : 0;
+}
+
+
+uint8 nwc_game_chunk_t::get_best_compression()
+{
+#ifdef USE_ZSTD
+	return ZSTD;
+#else
+	return ZLIB;
+#endif
 }
 
 
@@ -689,7 +820,10 @@ void nwc_sync_t::do_command(karte_t *welt)
 	// transfer game, all clients need to sync (save, reload, and pause)
 	// now save and send
 	dr_chdir( env_t::user_dir );
-	if(  !env_t::server  ) {
+	if(  env_t::server  &&  hot_join  ) {
+		send_snapshot(welt);
+	}
+	else if(  !env_t::server  ) {
 		char fn[256];
 		sprintf( fn, "client%i-network.sve", network_get_client_id() );
 
@@ -739,26 +873,13 @@ void nwc_sync_t::do_command(karte_t *welt)
 		}
 
 		// save game
-		sprintf( fn, "server%d-network.sve", env_t::server );
 		bool old_restore_UI = env_t::restore_UI;
 		env_t::restore_UI = true;
+		// the cached snapshot of hot joins is outdated by reloading
+		clear_snapshot();
+		get_join_filename( fn, welt->get_sync_steps() );
 		welt->save( fn, false, SERVER_SAVEGAME_VER_NR, EXTENDED_VER_NR, EXTENDED_REVISION_NR, false );
 
-		// ok, now sending game
-		// this sends nwc_game_t
-		const char *err = network_send_file( client_id, fn );
-		if (err) {
-			dbg->warning("nwc_sync_t::do_command","send game failed with: %s", err);
-		}
-
-		else {
-			// Knightly : synchronise the iteration limits
-			SOCKET sock = socket_list_t::get_socket(client_id);
-			if(  sock==INVALID_SOCKET  ||  !nwc_routesearch_t::transmit_active_limit_set(sock, welt->get_sync_steps(), new_map_counter)  ) {
-				dbg->warning("nwc_sync_t::do_command", "send of NWC_ROUTESEARCH failed");
-			}
-		}
-
 		uint32 old_sync_steps = welt->get_sync_steps();
 		welt->load( fn );
 		env_t::restore_UI = old_restore_UI;
@@ -769,29 +890,16 @@ void nwc_sync_t::do_command(karte_t *welt)
 		// apply new map counter
 		welt->set_map_counter(new_map_counter);
 
-		// unpause the client that received the game
-		// we do not want to wait for him (maybe loading failed due to pakset-errors)
-		SOCKET sock = socket_list_t::get_socket(client_id);
-		if(  sock != INVALID_SOCKET  ) {
-			nwc_ready_t nwc( old_sync_steps, welt->get_map_counter(), welt->get_checklist_at(old_sync_steps) );
-			if (nwc.send(sock)) {
-				socket_list_t::change_state( client_id, socket_info_t::playing);
-				if (socket_list_t::is_valid_client_id(client_id)) {
-					socket_list_t::get_client(client_id).player_unlocked = unlocked_players;
-					// send information about locked state
-					nwc_auth_player_t nwc;
-					nwc.player_unlocked = unlocked_players;
-					nwc.send(sock);
-
-					// welcome message
-					nwc_nick_t::server_tools(welt, client_id, nwc_nick_t::WELCOME, NULL);
-				}
-			}
-			else {
-				dbg->warning( "nwc_sync_t::do_command", "send of NWC_READY failed" );
-			}
-		}
-		nwc_join_t::pending_join_client = INVALID_SOCKET;
+		// now send the game, the commands were cleared by loading
+		// we do not want to wait for the client (maybe loading failed due to pakset-errors)
+		checksum_t checksum;
+		network_file_checksum( fn, checksum );
+		slist_tpl<packet_t *> commands;
+		send_game( welt, fn, checksum, 0, commands, old_sync_steps, welt->get_checklist_at(old_sync_steps), unlocked_players );
+		// kept for recovering the server after its transfer
+		char recovery_fn[256];
+		sprintf( recovery_fn, "server%d-network.sve", env_t::server );
+		network_release_file( fn, recovery_fn );
 	}
 	// restore screen coordinates & offsets
 	welt->get_viewport()->change_world_position(ij, xoff, yoff);
@@ -804,6 +912,158 @@ void nwc_sync_t::do_command(karte_t *welt)
 	}
 }
 
+nwc_sync_t::snapshot_t *nwc_sync_t::snapshot = NULL;
+
+
+nwc_sync_t::snapshot_t::~snapshot_t()
+{
+	while(  !commands.empty()  ) {
+		delete commands.remove_first();
+	}
+}
+
+
+void nwc_sync_t::get_join_filename(char *fn, uint32 sync_step)
+{
+	sprintf( fn, "server%d-network-%u.sve", env_t::server, sync_step );
+	for(  uint32 n=1;  network_file_in_transfer(fn);  n++  ) {
+		sprintf( fn, "server%d-network-%u-%u.sve", env_t::server, sync_step, n );
+	}
+}
+
+
+void nwc_sync_t::clear_snapshot()
+{
+	if(  snapshot  ) {
+		char recovery_fn[256];
+		sprintf( recovery_fn, "server%d-network.sve", env_t::server );
+		network_release_file( snapshot->filename, recovery_fn );
+	}
+	delete snapshot;
+	snapshot = NULL;
+}
+
+
+void nwc_sync_t::log_command(network_command_t *nwc)
+{
+	if(  snapshot  &&  dynamic_cast<network_world_command_t *>(nwc)  ) {
+		if(  dr_time() - snapshot->time > (uint32)env_t::server_snapshot_reuse_time * 1000  ) {
+			// too old to be sent again
+			clear_snapshot();
+		}
+		else {
+			snapshot->commands.append( nwc->copy_packet() );
+		}
+	}
+}
+
+
+void nwc_sync_t::send_snapshot(karte_t *welt)
+{
+	if(  snapshot  &&  (snapshot->map_counter != welt->get_map_counter()  ||  dr_time() - snapshot->time > (uint32)env_t::server_snapshot_reuse_time * 1000)  ) {
+		clear_snapshot();
+	}
+
+	uint16 unlocked_players = 0;
+	pwd_hash_t pwd_hashes[PLAYER_UNOWNED];
+	for(  int i=0;  i<PLAYER_UNOWNED; i++  ) {
+		player_t *player = welt->get_player(i);
+		if(  player==NULL  ||  player->access_password_hash().empty()  ) {
+			unlocked_players |= (1<<i);
+		}
+		else {
+			pwd_hashes[i] = player->access_password_hash();
+		}
+	}
+
+	if(  snapshot == NULL  ) {
+		// remove passwords during saving
+		for(  int i=0;  i<PLAYER_UNOWNED; i++  ) {
+			if(  (unlocked_players & (1<<i)) == 0  ) {
+				welt->get_player(i)->access_password_hash().clear();
+			}
+		}
+		char fn[256];
+		get_join_filename( fn, welt->get_sync_steps() );
+		bool old_restore_UI = env_t::restore_UI;
+		env_t::restore_UI = true;
+		welt->save( fn, false, SERVER_SAVEGAME_VER_NR, EXTENDED_VER_NR, EXTENDED_REVISION_NR, false );
+		env_t::restore_UI = old_restore_UI;
+		for(  int i=0;  i<PLAYER_UNOWNED; i++  ) {
+			if(  (unlocked_players & (1<<i)) == 0  ) {
+				welt->get_player(i)->access_password_hash() = pwd_hashes[i];
+			}
+		}
+
+		snapshot = new snapshot_t();
+		snapshot->sync_step = welt->get_sync_steps();
+		snapshot->map_counter = welt->get_map_counter();
+		snapshot->time = dr_time();
+		snapshot->checklist = welt->get_checklist_at(snapshot->sync_step);
+		snapshot->filename = fn;
+		network_file_checksum( fn, snapshot->checksum );
+		// commands scheduled for this or later sync steps are not contained in the snapshot,
+		// neither are those received but not processed yet
+		FOR(slist_tpl<network_world_command_t*>, const nwc, welt->get_command_queue()) {
+			snapshot->commands.append( nwc->copy_packet() );
+		}
+		FOR(slist_tpl<network_command_t*>, const nwc, network_get_received_commands()) {
+			if(  dynamic_cast<network_world_command_t *>(nwc)  ) {
+				snapshot->commands.append( nwc->copy_packet() );
+			}
+		}
+	}
+	else {
+		dbg->message("nwc_sync_t::send_snapshot", "sending snapshot of sync_step %u with %u commands", snapshot->sync_step, snapshot->commands.get_count());
+	}
+
+	// the client replays these commands while catching up, all later commands reach it by network_send_all()
+	slist_tpl<packet_t *> commands;
+	FOR(slist_tpl<packet_t *>, const p, snapshot->commands) {
+		commands.append( new packet_t(*p) );
+	}
+	// a partially received game is continued, if it is still the same
+	const uint32 offset = resume_offset > 0  &&  resume_checksum == snapshot->checksum ? resume_offset : 0;
+	send_game( welt, snapshot->filename, snapshot->checksum, offset, commands, snapshot->sync_step, snapshot->checklist, unlocked_players );
+}
+
+
+void nwc_sync_t::send_game(karte_t *welt, const char *filename, const checksum_t &checksum, uint32 offset, slist_tpl<packet_t *> &commands, uint32 sync_step, const checklist_t &checklist, uint16 unlocked_players) const
+{
+	// the iteration limits are needed before loading, nwc_ready_t after all commands to replay
+	slist_tpl<packet_t *> epilogue;
+	epilogue.append( nwc_routesearch_t::pack_active_limit_set(welt->get_sync_steps(), welt->get_map_counter()) );
+	epilogue.append_list( commands );
+	nwc_ready_t nwc_ready( sync_step, welt->get_map_counter(), checklist );
+	nwc_ready.prepare_to_send();
+	epilogue.append( nwc_ready.copy_packet() );
+	// send information about locked state
+	nwc_auth_player_t nwc_auth;
+	nwc_auth.player_unlocked = unlocked_players;
+	nwc_auth.prepare_to_send();
+	epilogue.append( nwc_auth.copy_packet() );
+
+	// this sends nwc_game_t, the client is still pending until the transfer has finished
+	const char *err = network_send_file( client_id, filename, checksum, offset, compression, epilogue );
+	if(  err  ) {
+		dbg->warning("nwc_sync_t::send_game", "send game failed with: %s", err);
+		while(  !epilogue.empty()  ) {
+			delete epilogue.remove_first();
+		}
+		nwc_join_t::pending_join_client = INVALID_SOCKET;
+		return;
+	}
+
+	// the client receives all further commands while loading
+	socket_list_t::change_state( client_id, socket_info_t::playing);
+	if (socket_list_t::is_valid_client_id(client_id)) {
+		socket_list_t::get_client(client_id).player_unlocked = unlocked_players;
+		// welcome message
+		nwc_nick_t::server_tools(welt, client_id, nwc_nick_t::WELCOME, NULL);
+	}
+}
+
+
 slist_tpl<nwc_routesearch_t::client_entry_t> nwc_routesearch_t::client_entries;
 path_explorer_t::limit_set_t nwc_routesearch_t::active_limit_set;
 path_explorer_t::limit_set_t nwc_routesearch_t::min_limit_set;
@@ -896,19 +1156,18 @@ void nwc_routesearch_t::check_for_transmission(karte_t *world)
 }
 
 
-bool nwc_routesearch_t::transmit_active_limit_set(SOCKET client_socket, uint32 sync_step, uint32 map_counter)
+packet_t *nwc_routesearch_t::pack_active_limit_set(uint32 sync_step, uint32 map_counter)
 {
 	// check if the active limit set is valid -> if not, initialise the active limit set
 	if(  active_limit_set==path_explorer_t::limit_set_t()  ) {
 		active_limit_set = path_explorer_t::get_active_limits();
 	}
-	// now send out the active limit set
 	nwc_routesearch_t nwrs(sync_step, map_counter, active_limit_set, true);
-	const bool success = nwrs.send(client_socket);
-	dbg->warning("nwc_routesearch_t::transmit_active_limit_set", "transmit %s sync_step=%u map_counter=%u limits=(%u, %u, %u, %llu, %u)",
-		success ? "succeeded" : "failed", sync_step, map_counter, active_limit_set.rebuild_connexions, active_limit_set.filter_eligible,
+	nwrs.prepare_to_send();
+	dbg->warning("nwc_routesearch_t::pack_active_limit_set", "transmit sync_step=%u map_counter=%u limits=(%u, %u, %u, %llu, %u)",
+		sync_step, map_counter, active_limit_set.rebuild_connexions, active_limit_set.filter_eligible,
 		active_limit_set.fill_matrix, active_limit_set.explore_paths, active_limit_set.reroute_goods);
-	return success;
+	return nwrs.copy_packet();
 }
 
 
@@ -972,6 +1231,39 @@ void nwc_check_t::rdwr()
 }
 
 
+void nwc_state_hash_t::rdwr()
+{
+	network_command_t::rdwr();
+	packet->rdwr_long(sync_step);
+	packet->rdwr_long(map_counter);
+	packet->rdwr_long(interval);
+	packet->rdwr_byte(level);
+	packet->rdwr_byte(subsystem);
+	packet->rdwr_short(bucket);
+	packet->rdwr_bool(request);
+	uint16 count = data.get_count();
+	packet->rdwr_short(count);
+	if(  packet->is_loading()  ) {
+		data.clear();
+		data.resize(count);
+	}
+	for(  uint16 i=0;  i<count;  i++  ) {
+		uint32 value = packet->is_saving() ? data[i] : 0;
+		packet->rdwr_long(value);
+		if(  packet->is_loading()  ) {
+			data.append(value);
+		}
+	}
+}
+
+
+bool nwc_state_hash_t::execute(karte_t *welt)
+{
+	state_hash_t::receive(welt, this);
+	return true;
+}
+
+
 void network_broadcast_world_command_t::rdwr()
 {
 	network_world_command_t::rdwr();
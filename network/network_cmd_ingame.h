@@ -9,6 +9,7 @@
 
 #include "network_cmd.h"
 #include "memory_rw.h"
+#include "checksum.h"
 #include "../simworld.h"
 #include "../tpl/slist_tpl.h"
 #include "../utils/plainstring.h"
@@ -112,7 +113,7 @@ private:
 class nwc_join_t : public nwc_nick_t {
 public:
 	nwc_join_t(const char* nick=NULL)
-	: nwc_nick_t(nick), client_id(0), answer(0) { id = NWC_JOIN; }
+	: nwc_nick_t(nick), client_id(0), answer(0), compression(0), resume_offset(0) { id = NWC_JOIN; }
 
 	bool execute(karte_t *) OVERRIDE;
 	void rdwr() OVERRIDE;
@@ -120,6 +121,13 @@ public:
 	uint32 client_id;
 	uint8 answer;
 
+	/// from client: best compression of nwc_game_chunk_t the client can unpack
+	uint8 compression;
+	/// from client: length of a partially received game, which can be continued
+	uint32 resume_offset;
+	/// from client: checksum of the partially received game
+	checksum_t resume_checksum;
+
 	/**
 	 * this clients is in the process of joining
 	 */
@@ -164,15 +172,62 @@ private:
  * nwc_game_t
  * @from-server:
  *      @data len of savegame
- *     client processes this in network_connect
+ *      @data offset transfer starts here (continues a partially received game)
+ *      @data checksum of the savegame, identifies it when continuing
+ *     followed by nwc_game_chunk_t's, client processes this in network_connect
  */
 class nwc_game_t : public network_command_t {
 public:
-	nwc_game_t(uint32 len_=0) : network_command_t(NWC_GAME), len(len_) {}
+	nwc_game_t(uint32 len_=0) : network_command_t(NWC_GAME), len(len_), offset(0) {}
 
 	void rdwr() OVERRIDE;
 	const char* get_name() OVERRIDE { return "nwc_game_t";}
 	uint32 len;
+	uint32 offset;
+	checksum_t checksum;
+};
+
+/**
+ * nwc_game_chunk_t
+ * @from-server:
+ *      @data offset position in the savegame
+ *      @data len uncompressed length
+ *      @data method compression
+ *      @data data (compressed) part of the savegame
+ *      @data checksum of the uncompressed data
+ *     client processes this in network_connect
+ */
+class nwc_game_chunk_t : public network_command_t {
+public:
+	/// uncompressed size of a chunk, such that it fits into one packet
+	enum { CHUNK_SIZE = 8000 };
+
+	/// compression methods, sorted by preference
+	enum { RAW = 0, ZLIB = 1, ZSTD = 2 };
+
+	nwc_game_chunk_t() : network_command_t(NWC_GAME_CHUNK), offset(0), len(0), method(RAW), size(0) {}
+
+	void rdwr() OVERRIDE;
+	const char* get_name() OVERRIDE { return "nwc_game_chunk_t";}
+
+	/// compresses @p raw_len bytes using @p compression, if this makes them smaller
+	void pack(const uint8 *raw, uint16 raw_len, uint8 compression);
+
+	/**
+	 * uncompresses the chunk into @p dest
+	 * @return length of the chunk or zero if it is corrupted
+	 */
+	uint16 unpack(uint8 *dest, uint16 dest_size) const;
+
+	/// best compression this build supports
+	static uint8 get_best_compression();
+
+	uint32 offset;
+	uint16 len;
+	uint8 method;
+	uint16 size;
+	uint8 data[CHUNK_SIZE];
+	checksum_t checksum;
 };
 
 /**
@@ -213,16 +268,60 @@ protected:
  */
 class nwc_sync_t : public network_world_command_t {
 public:
-	nwc_sync_t() : network_world_command_t(NWC_SYNC, 0, 0), client_id(0), new_map_counter(0) {};
-	nwc_sync_t(uint32 sync_steps, uint32 map_counter, uint32 send_to_client, uint32 _new_map_counter) : network_world_command_t(NWC_SYNC, sync_steps, map_counter), client_id(send_to_client), new_map_counter(_new_map_counter) { }
+	nwc_sync_t() : network_world_command_t(NWC_SYNC, 0, 0), client_id(0), new_map_counter(0), hot_join(false), compression(0), resume_offset(0) {};
+	nwc_sync_t(uint32 sync_steps, uint32 map_counter, uint32 send_to_client, uint32 _new_map_counter, bool _hot_join = false) : network_world_command_t(NWC_SYNC, sync_steps, map_counter), client_id(send_to_client), new_map_counter(_new_map_counter), hot_join(_hot_join), compression(0), resume_offset(0) { }
 
 	void rdwr() OVERRIDE;
 	void do_command(karte_t*) OVERRIDE;
 	const char* get_name() OVERRIDE { return "nwc_sync_t"; }
 	uint32 get_new_map_counter() const { return new_map_counter; }
+
+	/// server only, not transmitted: how to send the game, see nwc_join_t
+	void set_transfer(uint8 compression_, uint32 resume_offset_, const checksum_t &resume_checksum_) {
+		compression = compression_;
+		resume_offset = resume_offset_;
+		resume_checksum = resume_checksum_;
+	}
+
+	/// server: remembers the world commands sent after the join snapshot was taken
+	static void log_command(network_command_t *nwc);
+
+	/// server: forgets the join snapshot
+	static void clear_snapshot();
 private:
 	uint32 client_id; // this client shall receive the game
 	uint32 new_map_counter; // map counter to be applied to the new world after game reloading
+	bool hot_join; // only the joining client loads the game (server only, not transmitted)
+	uint8 compression;
+	uint32 resume_offset;
+	checksum_t resume_checksum;
+
+	/**
+	 * Hot join: the last snapshot is sent to further joining clients for a while,
+	 * together with all world commands sent since it was taken.
+	 */
+	struct snapshot_t {
+		uint32 sync_step;
+		uint32 map_counter;
+		uint32 time;           ///< when it was taken (dr_time())
+		checklist_t checklist; ///< at sync_step
+		checksum_t checksum;   ///< of the savegame
+		plainstring filename;  ///< of the savegame, only used by this snapshot and its transfers
+		slist_tpl<packet_t *> commands; ///< commands to execute at or after sync_step, in the order they were sent
+
+		~snapshot_t();
+	};
+	static snapshot_t *snapshot;
+
+	/// server: a new file name for a game sent to joining clients, which no transfer reads
+	static void get_join_filename(char *fn, uint32 sync_step);
+
+	/// server: sends snapshot and pending commands to the joining client, without reloading
+	void send_snapshot(karte_t *welt);
+
+	/// server: starts sending the game in @p filename, followed by @p commands and
+	/// nwc_ready_t for @p sync_step; then the client may play
+	void send_game(karte_t *welt, const char *filename, const checksum_t &checksum, uint32 offset, slist_tpl<packet_t *> &commands, uint32 sync_step, const checklist_t &checklist, uint16 unlocked_players) const;
 };
 
 /**
@@ -244,7 +343,8 @@ public:
 	virtual void do_command(karte_t *world);
 
 	static void check_for_transmission(karte_t *world);
-	static bool transmit_active_limit_set(SOCKET client_socket, uint32 sync_step, uint32 map_counter);
+	/// @return packet with the active limit set for a joining client
+	static packet_t *pack_active_limit_set(uint32 sync_step, uint32 map_counter);
 	static void remove_client_entry(uint32 client_id);
 	static void reset();
 private:
@@ -288,6 +388,36 @@ public:
 	bool ignore_old_events() const OVERRIDE { return true; }
 };
 
+/**
+ * nwc_state_hash_t, see state_hash_t
+ * @from-server:
+ *      @data sync_step, map_counter, interval
+ *      @data level what data contains: hashes of all subsystems, of the buckets of subsystem, or
+ *            pairs of object id and hash of the leaves in bucket of subsystem
+ *      clients compare the hashes with their own ones and request more details on mismatch
+ * @from-client:
+ *      @data request the buckets of subsystem, or the leaves of bucket of subsystem
+ */
+class nwc_state_hash_t : public network_command_t {
+public:
+	enum { SUBSYSTEMS = 0, BUCKETS, LEAVES };
+
+	nwc_state_hash_t() : network_command_t(NWC_STATE_HASH), sync_step(0), map_counter(0), interval(0), level(SUBSYSTEMS), subsystem(0), bucket(0), request(false) { }
+
+	bool execute(karte_t *) OVERRIDE;
+	void rdwr() OVERRIDE;
+	const char* get_name() OVERRIDE { return "nwc_state_hash_t"; }
+
+	uint32 sync_step;
+	uint32 map_counter;
+	uint32 interval;
+	uint8 level;
+	uint8 subsystem;
+	uint16 bucket;
+	bool request;
+	vector_tpl<uint32> data;
+};
+
 /**
  * commands that need to be executed at a certain syncstep
  * the command will be cloned at the server and broadcasted to all clients
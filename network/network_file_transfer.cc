@@ -91,6 +91,7 @@ char const* network_receive_file( SOCKET const s, char const* const save_as, sin
 
 #include "network_cmd.h"
 #include "network_cmd_ingame.h"
+#include "network_packet.h"
 #include "network_socket_list.h"
 
 #include "../dataobj/loadsave.h"
@@ -98,6 +99,8 @@ char const* network_receive_file( SOCKET const s, char const* const save_as, sin
 #include "../dataobj/environment.h"
 #include "../simworld.h"
 #include "../utils/simstring.h"
+#include "../tpl/slist_tpl.h"
+#include "../utils/plainstring.h"
 
 
 // connect to address (cp), receive gameinfo, close
@@ -170,9 +173,95 @@ end:
 }
 
 
+/**
+ * The partially received game of an interrupted join, which the server may continue,
+ * if the next join gets the same snapshot.
+ */
+static const char *partial_filename = "network-join.part";
+static uint32 partial_length = 0;
+static checksum_t partial_checksum;
+
+
+/**
+ * Receives the chunks of the game announced by @p nwg and saves it as @p filename.
+ * All other commands received meanwhile are appended to @p received.
+ */
+static const char *network_receive_game( const nwc_game_t *nwg, const char *filename, slist_tpl<network_command_t *> &received )
+{
+	FILE *f = NULL;
+	if(  nwg->offset > 0  ) {
+		if(  partial_length != nwg->offset  ||  !(partial_checksum == nwg->checksum)  ) {
+			return "Protocol error (cannot continue transfer)";
+		}
+		f = dr_fopen( partial_filename, "ab" );
+	}
+	else {
+		f = dr_fopen( partial_filename, "wb" );
+	}
+	if(  f == NULL  ) {
+		return "Could not open file";
+	}
+	partial_checksum = nwg->checksum;
+	partial_length = nwg->offset;
+	DBG_MESSAGE("network_receive_game", "File size %u, starting at %u", nwg->len, nwg->offset );
+
+	loadingscreen_t ls( translator::translate("Transferring game ..."), nwg->len, true, true );
+	ls.set_progress( partial_length );
+
+	const char *err = NULL;
+	uint8 buffer[nwc_game_chunk_t::CHUNK_SIZE];
+	while(  partial_length < nwg->len  ) {
+		network_command_t *nwc = network_check_activity( NULL, 10000 );
+		if(  nwc == NULL  ) {
+			err = "Not enough bytes transferred";
+			break;
+		}
+		nwc_game_chunk_t *chunk = dynamic_cast<nwc_game_chunk_t *>(nwc);
+		if(  chunk == NULL  ) {
+			// sent to all clients meanwhile: execute after loading
+			received.append( nwc );
+			continue;
+		}
+		const uint16 len = chunk->offset == partial_length ? chunk->unpack( buffer, sizeof(buffer) ) : 0;
+		delete chunk;
+		if(  len == 0  ) {
+			err = "Protocol error (corrupted game)";
+			break;
+		}
+		if(  fwrite( buffer, 1, len, f ) != len  ) {
+			err = "Could not write file";
+			partial_length = 0;
+			break;
+		}
+		partial_length += len;
+		ls.set_progress( partial_length );
+	}
+	fclose( f );
+
+	if(  err == NULL  ) {
+		// the chunks only tell their offset, so verify the whole file before loading it
+		checksum_t checksum;
+		if(  !network_file_checksum( partial_filename, checksum )  ||  !(checksum == nwg->checksum)  ) {
+			dbg->warning("network_receive_game", "checksum mismatch of received game");
+			dr_remove( partial_filename );
+			partial_length = 0;
+			return "Protocol error (checksum mismatch)";
+		}
+		partial_length = 0;
+		dr_remove( filename );
+		if(  dr_rename( partial_filename, filename ) != 0  ) {
+			err = "Could not write file";
+		}
+	}
+	return err;
+}
+
+
 // connect to address (cp), receive game, save to client%i-network.sve
 const char *network_connect(const char *cp, karte_t *world)
 {
+	// commands received during the transfer, to be executed after loading
+	slist_tpl<network_command_t *> received;
 	// open from network
 	const char *err = NULL;
 	SOCKET const my_client_socket = network_open_address(cp, err);
@@ -180,6 +269,12 @@ const char *network_connect(const char *cp, karte_t *world)
 		// want to join
 		{
 			nwc_join_t nwc_join( env_t::nickname.c_str() );
+			nwc_join.compression = nwc_game_chunk_t::get_best_compression();
+			if(  partial_length > 0  ) {
+				// maybe the server still sends the same game
+				nwc_join.resume_offset = partial_length;
+				nwc_join.resume_checksum = partial_checksum;
+			}
 			nwc_join.rdwr();
 			if (!nwc_join.send(my_client_socket)) {
 				err = "send of NWC_JOIN failed";
@@ -242,28 +337,48 @@ const char *network_connect(const char *cp, karte_t *world)
 			err = "Protocol error (expected NWC_GAME)";
 			goto end;
 		}
-		int len = ((nwc_game_t*)nwc)->len;
 		// guaranteed individual file name ...
 		char filename[256];
 		sprintf( filename, "client%i-network.sve", network_get_client_id() );
-		if(  (err = network_receive_file( my_client_socket, filename, len )) != NULL  ) {
+		err = network_receive_game( (nwc_game_t*)nwc, filename, received );
+		delete nwc;
+		if(  err  ) {
 			goto end;
 		}
 		// Knightly : update iteration limits
-		// wait for routesearch command (tolerate some wrong commands)
-		for(  uint8 i=0;  i<5;  ++i  ) {
-			nwc = network_check_activity( NULL, 10000 );
-			if(  nwc  &&  nwc->get_id()==NWC_ROUTESEARCH  ) break;
+		// wait for routesearch command, which follows the game
+		while(  (nwc = network_check_activity( NULL, 10000 ))  &&  nwc->get_id()!=NWC_ROUTESEARCH  ) {
+			received.append( nwc );
 		}
-		if(  nwc==NULL  ||  nwc->get_id()!=NWC_ROUTESEARCH  ) {
+		if(  nwc==NULL  ) {
 			err = "Protocol error (expected NWC_ROUTESEARCH)";
 			goto end;
 		}
 		((nwc_routesearch_t*)nwc)->do_command(world);
+		delete nwc;
+		// then the commands to replay until nwc_ready_t, which are older than those received during the transfer
+		slist_tpl<network_command_t *> replay;
+		while(  (nwc = network_check_activity( NULL, 10000 ))  ) {
+			replay.append( nwc );
+			if(  nwc->get_id()==NWC_READY  ) {
+				break;
+			}
+		}
+		replay.append_list( received );
+		if(  nwc==NULL  ) {
+			received.append_list( replay );
+			err = "Protocol error (expected NWC_READY)";
+			goto end;
+		}
+		// executed after loading
+		network_prepend_received_commands( replay );
 	}
 end:
 	if(err) {
 		dbg->warning("network_connect", err);
+		while(  !received.empty()  ) {
+			delete received.remove_first();
+		}
 		if (!socket_list_t::remove_client(my_client_socket)) {
 			network_close_socket( my_client_socket );
 		}
@@ -276,52 +391,214 @@ end:
 }
 
 
-const char *network_send_file( uint32 client_id, const char *filename )
+/**
+ * A savegame being sent to a client: the chunks are appended to its send queue
+ * whenever this runs low, such that the server keeps playing meanwhile.
+ */
+struct file_transfer_t
+{
+	uint32 client_id;
+	SOCKET socket; ///< to notice, when the client left and its id is reused
+	FILE *file;
+	uint32 offset;
+	uint32 length;
+	uint8 compression;
+	plainstring filename;
+	slist_tpl<packet_t *> epilogue; ///< queued after the last chunk
+
+	~file_transfer_t()
+	{
+		fclose(file);
+		while(  !epilogue.empty()  ) {
+			delete epilogue.remove_first();
+		}
+	}
+};
+
+static slist_tpl<file_transfer_t *> file_transfers;
+
+/// a file the server does not need anymore, which is removed after its last transfer
+struct released_file_t
+{
+	plainstring filename;
+	plainstring keep_as; ///< renamed to this instead of being removed, if not NULL
+};
+
+static slist_tpl<released_file_t *> released_files;
+
+// chunks in the send queue of a client, before the transfer waits
+#define MAX_QUEUED_CHUNKS (8)
+
+
+const char *network_send_file( uint32 client_id, const char *filename, const checksum_t &checksum, uint32 offset, uint8 compression, slist_tpl<packet_t *> &epilogue )
 {
+	const SOCKET s = socket_list_t::get_socket(client_id);
+	if(  s==INVALID_SOCKET  ) {
+		return "Client closed connection during transfer";
+	}
 	FILE *fp = dr_fopen(filename,"rb");
 	if (fp == NULL) {
 		dbg->warning("network_send_file", "could not open file %s", filename);
 		return "Could not open file";
 	}
-	char buffer[1024];
 
 	// find out length
 	fseek(fp, 0, SEEK_END);
-	long length = (long)ftell(fp);
-	rewind(fp);
-	sint32 bytes_sent = 0;
+	const uint32 length = (uint32)ftell(fp);
+	if(  offset > length  ) {
+		offset = 0;
+	}
+	fseek(fp, offset, SEEK_SET);
 
-	// send size of file
+	// send size of file: queued behind all commands sent so far, which the client ignores
 	nwc_game_t nwc(length);
-	SOCKET s = socket_list_t::get_socket(client_id);
-	if (s==INVALID_SOCKET  ||  !nwc.send(s)) {
-		goto error;
+	nwc.offset = offset;
+	nwc.checksum = checksum;
+	nwc.prepare_to_send();
+	socket_list_t::get_client(client_id).send_queue_append( nwc.copy_packet() );
+
+	file_transfer_t *transfer = new file_transfer_t();
+	transfer->client_id = client_id;
+	transfer->socket = s;
+	transfer->file = fp;
+	transfer->offset = offset;
+	transfer->length = length;
+	transfer->compression = compression;
+	transfer->filename = filename;
+	transfer->epilogue.append_list( epilogue );
+	file_transfers.append( transfer );
+	dbg->message("network_send_file", "sending %s to client %u from %u of %u bytes", filename, client_id, offset, length);
+	return NULL;
+}
+
+
+bool network_file_in_transfer( const char *filename )
+{
+	FOR(slist_tpl<file_transfer_t *>, const transfer, file_transfers) {
+		if(  transfer->filename == filename  ) {
+			return true;
+		}
 	}
+	return false;
+}
 
-	// good place to show a progress bar
-	if(length>0) {
-		loadingscreen_t ls( translator::translate("Transferring game ..."), length, true, true );
-
-		while(  !feof(fp)  ) {
-			int bytes_read = (int)fread( buffer, 1, sizeof(buffer), fp );
-			uint16 dummy;
-			if( !network_send_data(s, buffer, bytes_read, dummy, 250) ) {
-				socket_list_t::remove_client(s);
-				goto error;
+
+// removes all released files, which are not read by a transfer anymore
+static void remove_released_files()
+{
+	for(  slist_tpl<released_file_t *>::iterator i = released_files.begin();  i != released_files.end();  ) {
+		released_file_t *released = *i;
+		if(  network_file_in_transfer( released->filename )  ) {
+			++i;
+			continue;
+		}
+		if(  released->keep_as  ) {
+			dr_remove( released->keep_as );
+			if(  dr_rename( released->filename, released->keep_as ) != 0  ) {
+				dbg->warning("remove_released_files", "could not rename %s to %s", released->filename.c_str(), released->keep_as.c_str());
+				dr_remove( released->filename );
 			}
-			bytes_sent += bytes_read;
-			ls.set_progress( bytes_sent );
 		}
+		else {
+			dr_remove( released->filename );
+		}
+		i = released_files.erase(i);
+		delete released;
+	}
+}
+
 
+void network_release_file( const char *filename, const char *keep_as )
+{
+	released_file_t *released = new released_file_t();
+	released->filename = filename;
+	released->keep_as = keep_as;
+	if(  keep_as  ) {
+		// an older game must not replace this one when its transfer ends later
+		FOR(slist_tpl<released_file_t *>, const older, released_files) {
+			if(  older->keep_as == keep_as  ) {
+				older->keep_as = NULL;
+			}
+		}
 	}
+	released_files.append( released );
+	remove_released_files();
+}
 
-	// ok, new client has savegame
-	fclose(fp);
-	return NULL;
-error:
-	// an error occurred: close file
+
+void network_process_file_transfers()
+{
+	const uint32 count = file_transfers.get_count();
+	for(  slist_tpl<file_transfer_t *>::iterator i = file_transfers.begin();  i != file_transfers.end();  ) {
+		file_transfer_t *transfer = *i;
+		if(  socket_list_t::get_socket(transfer->client_id) != transfer->socket  ) {
+			// client closed connection during transfer
+			dbg->warning("network_process_file_transfers", "client %u left after %u of %u bytes", transfer->client_id, transfer->offset, transfer->length);
+			if(  nwc_join_t::pending_join_client == transfer->socket  ) {
+				nwc_join_t::pending_join_client = INVALID_SOCKET;
+			}
+			i = file_transfers.erase(i);
+			delete transfer;
+			continue;
+		}
+
+		socket_info_t &info = socket_list_t::get_client(transfer->client_id);
+		uint8 buffer[nwc_game_chunk_t::CHUNK_SIZE];
+		while(  transfer->offset < transfer->length  &&  info.get_send_queue_count() < MAX_QUEUED_CHUNKS  ) {
+			const uint16 len = (uint16)fread( buffer, 1, min<uint32>(sizeof(buffer), transfer->length - transfer->offset), transfer->file );
+			if(  len == 0  ) {
+				// file was truncated meanwhile, the client will time out
+				dbg->warning("network_process_file_transfers", "could not read at %u", transfer->offset);
+				transfer->length = transfer->offset;
+				break;
+			}
+			nwc_game_chunk_t chunk;
+			chunk.offset = transfer->offset;
+			chunk.pack( buffer, len, transfer->compression );
+			chunk.prepare_to_send();
+			info.send_queue_append( chunk.copy_packet() );
+			transfer->offset += len;
+		}
+
+		if(  transfer->offset < transfer->length  ) {
+			++i;
+			continue;
+		}
+
+		// complete: the client may start playing after the epilogue
+		while(  !transfer->epilogue.empty()  ) {
+			info.send_queue_append( transfer->epilogue.remove_first() );
+		}
+		if(  nwc_join_t::pending_join_client == transfer->socket  ) {
+			nwc_join_t::pending_join_client = INVALID_SOCKET;
+		}
+		dbg->message("network_process_file_transfers", "sent %u bytes to client %u", transfer->length, transfer->client_id);
+		i = file_transfers.erase(i);
+		delete transfer;
+	}
+
+	if(  file_transfers.get_count() < count  ) {
+		remove_released_files();
+	}
+}
+
+
+bool network_file_checksum( const char *filename, checksum_t &checksum )
+{
+	checksum.reset();
+	FILE *fp = dr_fopen(filename,"rb");
+	if(  fp == NULL  ) {
+		checksum.finish();
+		return false;
+	}
+	uint8 buffer[16384];
+	size_t len;
+	while(  (len = fread( buffer, 1, sizeof(buffer), fp )) > 0  ) {
+		checksum.input( buffer, (uint32)len );
+	}
 	fclose(fp);
-	return "Client closed connection during transfer";
+	checksum.finish();
+	return true;
 }
 
 /// POST a message (poststr) to an HTTP server at the specified address and relative path (name)
@@ -15,6 +15,8 @@
 #include "network.h"
 
 class cbuffer_t;
+class checksum_t;
+class packet_t;
 class karte_t;
 class gameinfo_t;
 
@@ -24,8 +26,29 @@ const char *network_gameinfo(const char *cp, gameinfo_t *gi);
 // connects to server at (cp), receives game, save to client%i-network.sve
 const char* network_connect(const char *cp, karte_t *world);
 
-// sending file over network
-const char *network_send_file( uint32 client_id, const char *filename );
+/**
+ * Starts sending a savegame to a client: nwc_game_t is queued at once, the file follows
+ * as nwc_game_chunk_t's whenever the send queue of the client runs low,
+ * finally the packets in @p epilogue are queued (and @p epilogue is emptied).
+ * @param offset continue a partially transferred file here
+ * @param compression of the chunks, see nwc_game_chunk_t
+ */
+const char *network_send_file( uint32 client_id, const char *filename, const checksum_t &checksum, uint32 offset, uint8 compression, slist_tpl<packet_t *> &epilogue );
+
+// continues all running file transfers, called when sending
+void network_process_file_transfers();
+
+// true, if a running transfer reads @p filename
+bool network_file_in_transfer( const char *filename );
+
+/**
+ * The server does not need @p filename anymore: it is removed as soon as no transfer reads it.
+ * @param keep_as rename it to this instead, unless a later release claims the same name
+ */
+void network_release_file( const char *filename, const char *keep_as = NULL );
+
+// calculates the checksum of a file
+bool network_file_checksum( const char *filename, checksum_t &checksum );
 
 // receive file (directly to disk)
 char const* network_receive_file(SOCKET const s, char const* const save_as, const sint32 length, const sint32 timeout=10000 );
@@ -3,6 +3,8 @@
  * (see LICENSE.txt)
  */
 
+#include <string.h>
+
 #include "../simdebug.h"
 #include "network_packet.h"
 #include "network_socket_list.h"
@@ -25,7 +27,8 @@ packet_t::packet_t() : memory_rw_t(buf,MAX_PACKET_LEN,true),
 	sock(INVALID_SOCKET),
 	error(false),
 	ready(false),
-	count(0)
+	count(0),
+	refs(1)
 {
 	set_index(HEADER_SIZE);
 }
@@ -39,6 +42,7 @@ packet_t::packet_t(const packet_t &p) : memory_rw_t(buf,MAX_PACKET_LEN,true)
 	sock  = INVALID_SOCKET;
 	size  = 0;
 	count = 0;
+	refs  = 1;
 	uint16 index = p.get_current_index();
 	for(uint16 i = 0; i<index; i++) {
 		buf[i] = p.buf[i];
@@ -57,6 +61,34 @@ packet_t::packet_t(SOCKET sender) : memory_rw_t(buf,MAX_PACKET_LEN,false)
 	id = 0;
 	version = 0;
 	sock = sender;
+	refs = 1;
+}
+
+
+packet_t::packet_t(const uint8 *data, uint16 len) : memory_rw_t(buf,MAX_PACKET_LEN,false)
+{
+	version = 0;
+	count = 0;
+	size = 0;
+	id = 0;
+	sock = INVALID_SOCKET;
+	refs = 1;
+	error = ( len < HEADER_SIZE  ||  len > MAX_PACKET_LEN );
+	ready = false;
+	if (error) {
+		return;
+	}
+	memcpy(buf, data, len);
+	set_max_size(HEADER_SIZE);
+	set_index(0);
+	rdwr_header();
+	if (size != len) {
+		error = true;
+		return;
+	}
+	count = len;
+	set_max_size(size);
+	ready = true;
 }
 
 
@@ -104,11 +136,8 @@ void packet_t::recv()
 }
 
 
-void packet_t::send(SOCKET s, bool complete)
+void packet_t::write_header()
 {
-	if (has_failed()) {
-		return;
-	}
 	// header written ?
 	if (size == 0) {
 		size = get_current_index();
@@ -116,7 +145,19 @@ void packet_t::send(SOCKET s, bool complete)
 		set_index(0);
 		set_max_size(HEADER_SIZE);
 		rdwr_header();
+		// a copy still gets all data
+		set_index(size);
+		set_max_size(MAX_PACKET_LEN);
+	}
+}
+
+
+void packet_t::send(SOCKET s, bool complete)
+{
+	if (has_failed()) {
+		return;
 	}
+	write_header();
 
 	uint16 sent;
 	const int timeout_ms = complete ? 250 : 0;
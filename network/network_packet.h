@@ -38,6 +38,9 @@ private:
 	// how much already sent / received
 	uint16 count;
 
+	// number of send queues holding this packet
+	uint16 refs;
+
 
 	void rdwr_header();
 
@@ -54,6 +57,12 @@ public:
 	 */
 	packet_t(SOCKET s);
 
+	/**
+	 * constructor: packet is in loading-mode
+	 * @param data a complete packet including its header, e.g. from a recording
+	 */
+	packet_t(const uint8 *data, uint16 len);
+
 	/**
 	 * start/continue sending
 	 * sets bools ready or error
@@ -67,6 +76,21 @@ public:
 	 */
 	void recv();
 
+	/**
+	 * writes the header, afterwards the data can be sent
+	 * and the packet can be shared by several send queues
+	 */
+	void write_header();
+
+	/// the complete packet, valid after write_header()
+	const uint8 *get_data() const { return buf; }
+	uint16 get_size() const { return size; }
+
+	/// one more send queue holds this packet
+	void add_ref() { refs++; }
+	/// @return true if no send queue holds this packet any more, then it has to be deleted
+	bool release() { return --refs == 0; }
+
 	bool has_failed() const { return error  ||  is_overflow();}
 	void failed() { error = true; }
 	bool is_ready() const { return ready; }
@@ -74,6 +98,8 @@ public:
 	// can we understand the received packet?
 	bool check_version() const { return is_saving() || (version <= NETWORK_VERSION); }
 
+	uint16 get_version() const { return version; }
+
 	uint16 get_id() const { return id; }
 	void set_id(uint16 id_) { id = id_; }
 
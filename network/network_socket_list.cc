@@ -25,8 +25,11 @@ void socket_info_t::reset()
 	packet = NULL;
 	while(!send_queue.empty()) {
 		packet_t *p = send_queue.remove_first();
-		delete p;
+		if (p->release()) {
+			delete p;
+		}
 	}
+	send_offset = 0;
 	if (socket != INVALID_SOCKET) {
 		network_close_socket(socket);
 	}
@@ -67,20 +70,48 @@ network_command_t* socket_info_t::receive_nwc()
 void socket_info_t::process_send_queue()
 {
 	while(!send_queue.empty()) {
-		packet_t *p = send_queue.front();
-		p->send(socket, false);
-		if (p->has_failed()) {
+		// send several packets with one system call
+		network_buffer_t buffers[MAX_SEND_BUFFERS];
+		uint32 count = 0;
+		uint32 total = 0;
+		uint16 offset = send_offset;
+		FOR(slist_tpl<packet_t *>, const p, send_queue) {
+			if (count == MAX_SEND_BUFFERS) {
+				break;
+			}
+			buffers[count].data = p->get_data() + offset;
+			buffers[count].len = p->get_size() - offset;
+			total += buffers[count].len;
+			offset = 0;
+			count++;
+		}
+
+		uint32 sent;
+		if (!network_send_buffers(socket, buffers, count, sent)) {
 			// close this client, clear the send_queue
 			socket_list_t::remove_client(socket);
 			break;
 		}
-		else if (p->is_ready()) {
-			// packet complete sent, remove from queue
+		const bool all_sent = sent == total;
+
+		// remove the packets sent completely
+		while (sent > 0) {
+			packet_t *p = send_queue.front();
+			const uint32 left = p->get_size() - send_offset;
+			if (sent < left) {
+				send_offset += sent;
+				break;
+			}
+			sent -= left;
+			send_offset = 0;
 			send_queue.remove_first();
-			delete p;
-			// proceed with next packet
+			if (p->release()) {
+				delete p;
+			}
 		}
-		else {
+
+		if (!all_sent) {
+			// socket buffer is full, continue later
 			break;
 		}
 	}
@@ -91,9 +122,10 @@ void socket_info_t::send_queue_append(packet_t *p)
 {
 	if (p) {
 		if (!p->has_failed()) {
+			p->write_header();
 			send_queue.append(p);
 		}
-		else {
+		else if (p->release()) {
 			delete p;
 		}
 	}
@@ -200,6 +232,7 @@ void socket_list_t::add_client( SOCKET sock, uint32 ip )
 	change_state( i, socket_info_t::connected );
 
 	network_set_socket_nodelay( sock );
+	network_poll_add( sock, i );
 }
 
 
@@ -237,6 +270,7 @@ void socket_list_t::add_server( SOCKET sock )
 	}
 
 	network_set_socket_nodelay( sock );
+	network_poll_add( sock, i );
 }
 
 
@@ -326,13 +360,22 @@ void socket_list_t::send_all(network_command_t* nwc, bool only_playing_clients)
 	if (nwc == NULL) {
 		return;
 	}
+	// serialize once, all send queues share this packet
+	packet_t *p = nwc->copy_packet();
+	if (p == NULL) {
+		return;
+	}
+	p->write_header();
 	for(uint32 i=server_sockets; i<list.get_count(); i++) {
 		if (list[i]->is_active()  &&  list[i]->socket!=INVALID_SOCKET
 			&& (!only_playing_clients || list[i]->state == socket_info_t::playing || list[i]->state == socket_info_t::connected)) {
-			packet_t *p = nwc->copy_packet();
+			p->add_ref();
 			list[i]->send_queue_append(p);
 		}
 	}
+	if (p->release()) {
+		delete p;
+	}
 }
 
 
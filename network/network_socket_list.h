@@ -49,6 +49,8 @@ class socket_info_t : public connection_info_t {
 private:
 	packet_t *packet;
 	slist_tpl<packet_t *> send_queue;
+	/// bytes of the first packet in send_queue already sent
+	uint16 send_offset;
 
 
 public:
@@ -64,7 +66,7 @@ public:
 
 	SOCKET socket;
 
-	socket_info_t() : connection_info_t(), packet(0), send_queue(), state(inactive), socket(INVALID_SOCKET), player_unlocked(0) {}
+	socket_info_t() : connection_info_t(), packet(0), send_queue(), send_offset(0), state(inactive), socket(INVALID_SOCKET), player_unlocked(0) {}
 
 	~socket_info_t();
 
@@ -84,12 +86,16 @@ public:
 	network_command_t* receive_nwc();
 
 	/**
-	 *
+	 * sends as many queued packets as possible without blocking
+	 * if an error occurs while sending, (this) is reset
 	 */
 	void process_send_queue();
 
+	/// the packet may be shared with other queues, see packet_t::add_ref
 	void send_queue_append(packet_t *p);
 
+	uint32 get_send_queue_count() const { return send_queue.get_count(); }
+
 	/**
 	 * rdwr client information to packet
 	 */
@@ -0,0 +1,441 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include "state_hash.h"
+#include "network.h"
+#include "network_cmd_ingame.h"
+
+#include "../simworld.h"
+#include "../simconvoi.h"
+#include "../simhalt.h"
+#include "../simcity.h"
+#include "../simfab.h"
+#include "../simdebug.h"
+#include "../bauer/goods_manager.h"
+#include "../boden/wege/weg.h"
+#include "../boden/wege/schiene.h"
+#include "../dataobj/environment.h"
+#include "../sys/simsys.h"
+#include "../utils/cbuffer_t.h"
+
+
+state_hash_t::record_t *state_hash_t::records[RECORDS] = { NULL, NULL, NULL, NULL };
+uint32 state_hash_t::next_record = 0;
+uint32 state_hash_t::interval = 0;
+vector_tpl<state_hash_t::server_hashes_t> state_hash_t::pending;
+uint32 state_hash_t::bisected = 0;
+
+
+/// finalizer of MurmurHash3
+static inline uint32 fmix(uint32 h)
+{
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return h;
+}
+
+
+static inline uint32 combine(uint32 h, uint32 value)
+{
+	return fmix( h ^ (value + 0x9e3779b9u + (h << 6) + (h >> 2)) );
+}
+
+
+static inline uint32 pack_koord(koord k)
+{
+	return ((uint32)(uint16)k.x << 16) | (uint16)k.y;
+}
+
+
+static inline uint16 get_bucket(uint32 id)
+{
+	return fmix(id) % state_hash_t::BUCKETS;
+}
+
+
+const char *state_hash_t::get_subsystem_name(uint8 subsystem)
+{
+	static const char *names[SUBSYSTEM_COUNT] = { "convoys", "halts", "ways", "cities", "factories", "private cars" };
+	return subsystem < SUBSYSTEM_COUNT ? names[subsystem] : "unknown";
+}
+
+
+void state_hash_t::calc(karte_t *welt, record_t &record)
+{
+	record.sync_step = welt->get_sync_steps();
+	vector_tpl<uint32> *leaves = record.leaves;
+	for(  uint8 s=0;  s<SUBSYSTEM_COUNT;  s++  ) {
+		leaves[s].clear();
+	}
+
+	FOR(vector_tpl<convoihandle_t>, const cnv, welt->convoys()) {
+		const koord3d pos = cnv->get_pos();
+		uint32 h = combine( pack_koord(pos.get_2d()), pos.z );
+		h = combine( h, cnv->get_akt_speed() );
+		h = combine( h, cnv->get_state() );
+		leaves[CONVOYS].append( cnv.get_id() );
+		leaves[CONVOYS].append( h );
+	}
+
+	FOR(vector_tpl<halthandle_t>, const halt, haltestelle_t::get_alle_haltestellen()) {
+		uint32 h = 0;
+		for(  uint8 i=0;  i<goods_manager_t::get_count();  i++  ) {
+			h = combine( h, halt->get_ware_summe( goods_manager_t::get_info(i) ) );
+		}
+		leaves[HALTS].append( halt.get_id() );
+		leaves[HALTS].append( h );
+	}
+
+	// only ways with reservations or private car routes give leaves
+	const uint32 element = weg_t::private_car_routes_currently_reading_element;
+	FOR(vector_tpl<weg_t *>, const way, weg_t::get_alle_wege()) {
+		const koord3d pos = way->get_pos();
+		if(  const schiene_t *sch = dynamic_cast<const schiene_t *>(way)  ) {
+			if(  sch->get_reserved_convoi().is_bound()  ) {
+				uint32 h = combine( pos.z, way->get_waytype() );
+				h = combine( h, sch->get_reserved_convoi().get_id() );
+				h = combine( h, sch->get_reservation_type() );
+				h = combine( h, sch->get_reserved_direction() );
+				leaves[WAYS].append( pack_koord(pos.get_2d()) );
+				leaves[WAYS].append( h );
+			}
+		}
+		else if(  way->get_waytype() == road_wt  ) {
+			uint32 h = 0, count = 0;
+			for(  uint8 c=0;  c<5;  c++  ) {
+				const weg_t::private_car_route_map &routes = way->private_car_routes[element][c];
+				uint32 sum = 0;
+				for(  uint32 i=0;  i<routes.get_count();  i++  ) {
+					// the order of the destinations does not matter
+					sum += fmix( pack_koord(routes[i]) );
+				}
+				h = combine( combine( h, routes.get_count() ), sum );
+				count += routes.get_count();
+			}
+			if(  count > 0  ) {
+				leaves[PRIVATE_CARS].append( pack_koord(pos.get_2d()) );
+				leaves[PRIVATE_CARS].append( combine( h, pos.z ) );
+			}
+		}
+	}
+
+	FOR(weighted_vector_tpl<stadt_t *>, const city, welt->get_cities()) {
+		leaves[CITIES].append( pack_koord(city->get_pos()) );
+		leaves[CITIES].append( combine( city->get_einwohner(), city->get_buildings() ) );
+	}
+
+	FOR(vector_tpl<fabrik_t *>, const fab, welt->get_fab_list()) {
+		uint32 h = 0;
+		for(  uint32 i=0;  i<fab->get_input().get_count();  i++  ) {
+			h = combine( h, fab->get_input()[i].menge );
+		}
+		for(  uint32 i=0;  i<fab->get_output().get_count();  i++  ) {
+			h = combine( h, fab->get_output()[i].menge );
+		}
+		leaves[FACTORIES].append( pack_koord(fab->get_pos().get_2d()) );
+		leaves[FACTORIES].append( h );
+	}
+
+	// sums do not depend on the order of the objects
+	for(  uint8 s=0;  s<SUBSYSTEM_COUNT;  s++  ) {
+		for(  uint32 b=0;  b<BUCKETS;  b++  ) {
+			record.buckets[s][b] = 0;
+		}
+		uint32 sum = 0;
+		for(  uint32 i=0;  i+1<leaves[s].get_count();  i+=2  ) {
+			const uint32 leaf = combine( leaves[s][i], leaves[s][i+1] );
+			record.buckets[s][ get_bucket(leaves[s][i]) ] += leaf;
+			sum += leaf;
+		}
+		record.hash[s] = combine( sum, leaves[s].get_count() );
+	}
+}
+
+
+const state_hash_t::record_t *state_hash_t::get_record(uint32 sync_step)
+{
+	for(  uint32 i=0;  i<RECORDS;  i++  ) {
+		if(  records[i]  &&  records[i]->sync_step == sync_step  ) {
+			return records[i];
+		}
+	}
+	return NULL;
+}
+
+
+void state_hash_t::step(karte_t *welt)
+{
+	const uint32 sync_step = welt->get_sync_steps();
+	const uint32 every = env_t::server ? env_t::server_state_hash_interval : interval;
+	if(  every == 0  ||  sync_step % every != 0  ) {
+		return;
+	}
+
+	if(  records[next_record] == NULL  ) {
+		records[next_record] = new record_t();
+	}
+	record_t &record = *records[next_record];
+	next_record = (next_record + 1) % RECORDS;
+	calc( welt, record );
+
+	if(  env_t::server  ) {
+		nwc_state_hash_t *nwc = new nwc_state_hash_t();
+		nwc->sync_step = sync_step;
+		nwc->map_counter = welt->get_map_counter();
+		nwc->interval = every;
+		for(  uint8 s=0;  s<SUBSYSTEM_COUNT;  s++  ) {
+			nwc->data.append( record.hash[s] );
+		}
+		network_send_all( nwc, true );
+	}
+	else {
+		compare_pending( welt );
+	}
+}
+
+
+void state_hash_t::compare_pending(karte_t *welt)
+{
+	for(  uint32 i=0;  i<pending.get_count();  ) {
+		const server_hashes_t &server = pending[i];
+		const record_t *record = get_record( server.sync_step );
+		if(  record == NULL  ) {
+			if(  server.sync_step < welt->get_sync_steps()  ) {
+				// passed before the interval was known
+				pending.remove_at(i);
+			}
+			else {
+				i++;
+			}
+			continue;
+		}
+		for(  uint8 s=0;  s<SUBSYSTEM_COUNT;  s++  ) {
+			if(  record->hash[s] == server.hash[s]  ) {
+				continue;
+			}
+			dbg->warning("state_hash_t::compare_pending", "%s out of sync at sync_step=%u", get_subsystem_name(s), server.sync_step);
+			if(  (bisected & (1<<s)) == 0  ) {
+				// ask for the buckets of this subsystem
+				bisected |= 1<<s;
+				nwc_state_hash_t *nwc = new nwc_state_hash_t();
+				nwc->sync_step = server.sync_step;
+				nwc->map_counter = welt->get_map_counter();
+				nwc->level = nwc_state_hash_t::BUCKETS;
+				nwc->subsystem = s;
+				nwc->request = true;
+				network_send_server( nwc );
+			}
+		}
+		pending.remove_at(i);
+	}
+}
+
+
+void state_hash_t::receive(karte_t *welt, nwc_state_hash_t *nwc)
+{
+	if(  nwc->map_counter != welt->get_map_counter()  ) {
+		// from another world
+		return;
+	}
+
+	if(  env_t::server  ) {
+		if(  !nwc->request  ||  nwc->subsystem >= SUBSYSTEM_COUNT  ) {
+			return;
+		}
+		const record_t *record = get_record( nwc->sync_step );
+		if(  record == NULL  ) {
+			dbg->warning("state_hash_t::receive", "hashes of sync_step=%u not available any more", nwc->sync_step);
+			return;
+		}
+		nwc_state_hash_t answer;
+		answer.sync_step = nwc->sync_step;
+		answer.map_counter = nwc->map_counter;
+		answer.interval = env_t::server_state_hash_interval;
+		answer.level = nwc->level;
+		answer.subsystem = nwc->subsystem;
+		answer.bucket = nwc->bucket;
+		if(  nwc->level == nwc_state_hash_t::BUCKETS  ) {
+			for(  uint32 b=0;  b<BUCKETS;  b++  ) {
+				answer.data.append( record->buckets[nwc->subsystem][b] );
+			}
+		}
+		else {
+			const vector_tpl<uint32> &leaves = record->leaves[nwc->subsystem];
+			for(  uint32 i=0;  i+1<leaves.get_count()  &&  answer.data.get_count()<2*MAX_LEAVES;  i+=2  ) {
+				if(  get_bucket(leaves[i]) == nwc->bucket  ) {
+					answer.data.append( leaves[i] );
+					answer.data.append( leaves[i+1] );
+				}
+			}
+		}
+		if(  !answer.send( nwc->get_sender() )  ) {
+			dbg->warning("state_hash_t::receive", "send of NWC_STATE_HASH failed");
+		}
+		return;
+	}
+
+	if(  nwc->request  ) {
+		return;
+	}
+	if(  nwc->level == nwc_state_hash_t::SUBSYSTEMS  ) {
+		if(  nwc->data.get_count() != SUBSYSTEM_COUNT  ) {
+			return;
+		}
+		interval = nwc->interval;
+		server_hashes_t server;
+		server.sync_step = nwc->sync_step;
+		for(  uint8 s=0;  s<SUBSYSTEM_COUNT;  s++  ) {
+			server.hash[s] = nwc->data[s];
+		}
+		pending.append( server );
+		// the client may be there already
+		compare_pending( welt );
+		return;
+	}
+
+	const record_t *record = get_record( nwc->sync_step );
+	if(  record == NULL  ||  nwc->subsystem >= SUBSYSTEM_COUNT  ) {
+		dbg->warning("state_hash_t::receive", "own hashes of sync_step=%u not available any more, increase server_state_hash_interval", nwc->sync_step);
+		return;
+	}
+	if(  nwc->level == nwc_state_hash_t::BUCKETS  ) {
+		if(  nwc->data.get_count() != BUCKETS  ) {
+			return;
+		}
+		// ask for the leaves of the first buckets that differ
+		uint32 requests = 0;
+		for(  uint32 b=0;  b<BUCKETS  &&  requests<8;  b++  ) {
+			if(  record->buckets[nwc->subsystem][b] != nwc->data[b]  ) {
+				nwc_state_hash_t *request = new nwc_state_hash_t();
+				request->sync_step = nwc->sync_step;
+				request->map_counter = nwc->map_counter;
+				request->level = nwc_state_hash_t::LEAVES;
+				request->subsystem = nwc->subsystem;
+				request->bucket = b;
+				request->request = true;
+				network_send_server( request );
+				requests++;
+			}
+		}
+	}
+	else if(  nwc->level == nwc_state_hash_t::LEAVES  ) {
+		write_report( welt, *record, nwc );
+	}
+}
+
+
+/// describes the object with @p id of @p subsystem for the report
+static void describe_object(karte_t *welt, uint8 subsystem, uint32 id, cbuffer_t &buf)
+{
+	const koord pos( (sint16)(id >> 16), (sint16)(id & 0xFFFF) );
+	switch(  subsystem  ) {
+		case state_hash_t::CONVOYS:
+			buf.printf( "convoy %u", id );
+			FOR(vector_tpl<convoihandle_t>, const cnv, welt->convoys()) {
+				if(  cnv.get_id() == id  ) {
+					buf.printf( " \"%s\" at %s", cnv->get_name(), cnv->get_pos().get_str() );
+					break;
+				}
+			}
+			break;
+		case state_hash_t::HALTS:
+			buf.printf( "halt %u", id );
+			FOR(vector_tpl<halthandle_t>, const halt, haltestelle_t::get_alle_haltestellen()) {
+				if(  halt.get_id() == id  ) {
+					buf.printf( " \"%s\"", halt->get_name() );
+					break;
+				}
+			}
+			break;
+		case state_hash_t::CITIES:
+			buf.printf( "city at %s", pos.get_str() );
+			break;
+		case state_hash_t::FACTORIES: {
+			fabrik_t *fab = fabrik_t::get_fab( pos );
+			buf.printf( "factory \"%s\" at %s", fab ? fab->get_name() : "?", pos.get_str() );
+			break;
+		}
+		default:
+			buf.printf( "way at %s", pos.get_str() );
+	}
+}
+
+
+void state_hash_t::write_report(karte_t *welt, const record_t &record, const nwc_state_hash_t *nwc)
+{
+	// own leaves of this bucket
+	vector_tpl<uint32> own;
+	const vector_tpl<uint32> &leaves = record.leaves[nwc->subsystem];
+	for(  uint32 i=0;  i+1<leaves.get_count();  i+=2  ) {
+		if(  get_bucket(leaves[i]) == nwc->bucket  ) {
+			own.append( leaves[i] );
+			own.append( leaves[i+1] );
+		}
+	}
+
+	cbuffer_t buf;
+	buf.printf( "sync_step %u, %s, bucket %u%s\n", nwc->sync_step, get_subsystem_name(nwc->subsystem), nwc->bucket,
+		nwc->data.get_count() >= 2*MAX_LEAVES ? " (truncated by server)" : "" );
+	uint32 differences = 0;
+	vector_tpl<bool> matched( own.get_count() / 2 );
+	for(  uint32 j=0;  j+1<own.get_count();  j+=2  ) {
+		matched.append( false );
+	}
+	for(  uint32 i=0;  i+1<nwc->data.get_count();  i+=2  ) {
+		const uint32 id = nwc->data[i];
+		// several ways may share a tile, so prefer an equal leaf
+		sint32 found = -1;
+		for(  uint32 j=0;  j+1<own.get_count();  j+=2  ) {
+			if(  own[j] == id  &&  !matched[j/2]  ) {
+				if(  found < 0  ||  own[j+1] == nwc->data[i+1]  ) {
+					found = j;
+				}
+			}
+		}
+		if(  found < 0  ) {
+			describe_object( welt, nwc->subsystem, id, buf );
+			buf.append( ": only on server\n" );
+			differences++;
+			continue;
+		}
+		matched[found/2] = true;
+		if(  own[found+1] != nwc->data[i+1]  ) {
+			describe_object( welt, nwc->subsystem, id, buf );
+			buf.printf( ": server %08x, client %08x\n", nwc->data[i+1], own[found+1] );
+			differences++;
+		}
+	}
+	for(  uint32 j=0;  j+1<own.get_count();  j+=2  ) {
+		if(  !matched[j/2]  ) {
+			describe_object( welt, nwc->subsystem, own[j], buf );
+			buf.append( ": only on client\n" );
+			differences++;
+		}
+	}
+
+	char filename[256];
+	sprintf( filename, "desync-%u.txt", nwc->sync_step );
+	if(  FILE *f = dr_fopen( filename, "a" )  ) {
+		fputs( buf.get_str(), f );
+		fclose( f );
+	}
+	dbg->warning("state_hash_t::write_report", "%u differences of %s at sync_step=%u written to %s", differences, get_subsystem_name(nwc->subsystem), nwc->sync_step, filename);
+}
+
+
+void state_hash_t::reset()
+{
+	for(  uint32 i=0;  i<RECORDS;  i++  ) {
+		delete records[i];
+		records[i] = NULL;
+	}
+	next_record = 0;
+	interval = 0;
+	pending.clear();
+	bisected = 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef NETWORK_STATE_HASH_H
+#define NETWORK_STATE_HASH_H
+
+
+#include "../simtypes.h"
+#include "../tpl/vector_tpl.h"
+
+class karte_t;
+class nwc_state_hash_t;
+
+
+/**
+ * Hashes of the world state per subsystem, to find out where a desync came from.
+ *
+ * If the server has set server_state_hash_interval, server and clients hash
+ * every n-th sync step. The hashes form a tree: every object (convoy, halt, ...)
+ * gives a leaf, the leaves are summed up into buckets and the buckets into the hash
+ * of the subsystem. The server sends the subsystem hashes to the clients (nwc_state_hash_t).
+ * On a mismatch the client requests the buckets and then the leaves that differ,
+ * and writes a report listing the objects that went out of sync.
+ */
+class state_hash_t
+{
+public:
+	enum subsystem_t {
+		CONVOYS = 0,  ///< positions, speeds and states
+		HALTS,        ///< waiting cargo per goods type
+		WAYS,         ///< reservations of rails
+		CITIES,       ///< population and buildings
+		FACTORIES,    ///< input and output stocks
+		PRIVATE_CARS, ///< private car route tables of roads
+		SUBSYSTEM_COUNT
+	};
+
+	enum { BUCKETS = 256 };
+
+	/// maximum number of leaves sent in one packet
+	enum { MAX_LEAVES = 900 };
+
+	/// hashes of one sync step
+	struct record_t
+	{
+		uint32 sync_step;
+		uint32 hash[SUBSYSTEM_COUNT];
+		uint32 buckets[SUBSYSTEM_COUNT][BUCKETS];
+		/// pairs of object id and hash
+		vector_tpl<uint32> leaves[SUBSYSTEM_COUNT];
+	};
+
+	static const char *get_subsystem_name(uint8 subsystem);
+
+	/// called after every sync step in network games, hashes the world if due
+	static void step(karte_t *welt);
+
+	/// server: answers requests, client: compares with own hashes
+	static void receive(karte_t *welt, nwc_state_hash_t *nwc);
+
+	/// forgets all hashes, e.g. after loading
+	static void reset();
+
+private:
+	/// the last hashed sync steps
+	enum { RECORDS = 4 };
+	static record_t *records[RECORDS];
+	static uint32 next_record;
+
+	/// client: the interval of the server, zero if unknown
+	static uint32 interval;
+
+	/// client: subsystem hashes of the server not yet compared
+	struct server_hashes_t
+	{
+		uint32 sync_step;
+		uint32 hash[SUBSYSTEM_COUNT];
+	};
+	static vector_tpl<server_hashes_t> pending;
+
+	/// client: subsystems that were already bisected, reported only once
+	static uint32 bisected;
+
+	static const record_t *get_record(uint32 sync_step);
+
+	static void calc(karte_t *welt, record_t &record);
+
+	/// client: compares pending subsystem hashes with own records
+	static void compare_pending(karte_t *welt);
+
+	/// client: writes the leaves that differ in a bucket
+	static void write_report(karte_t *welt, const record_t &record, const nwc_state_hash_t *nwc);
+};
+
+#endif
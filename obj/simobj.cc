@@ -14,6 +14,7 @@
 #include "../display/simimg.h"
 #include "../display/viewport.h"
 #include "../player/simplay.h"
+#include "../gui/minimap.h"
 #include "../gui/obj_info.h"
 #include "../gui/simwin.h"
 #include "../vehicle/simvehicle.h"
@@ -129,6 +130,10 @@ void obj_t::set_owner(player_t *player)
 {
 	int i = welt->sp2num(player);
 	assert(i>=0);
+	if(  owner_n != (uint8)i  &&  !is_moving()  ) {
+		// the owner is shown on the minimap
+		minimap_t::get_instance()->invalidate_map_area( get_pos().get_2d(), get_pos().get_2d() );
+	}
 	owner_n = (uint8)i;
 }
 
@@ -1852,11 +1852,8 @@ void path_explorer_t::compartment_t::step()
 
 				++phase_counter;
 
-				// iteration control
-				if ( use_limits && iterations == limit_reroute_goods )
-				{
-					break;
-				}
+				// No iteration control: this only queues the halts, the re-routing
+				// itself is done by haltestelle_t::step_all() on all threads.
 			}
 
 			diff = dr_time() - start;	// stop timing
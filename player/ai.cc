@@ -83,6 +83,25 @@ halthandle_t ai_t::get_halt(const koord pos ) const
  * if there is already a connection
  */
 bool ai_t::is_connected( const koord start_pos, const koord dest_pos, const goods_desc_t *wtyp ) const
+{
+	if(  connection_cache_steps != welt->get_steps()  ) {
+		connection_cache.clear();
+		connection_cache_steps = welt->get_steps();
+	}
+	ai_connection_t key;
+	key.start = start_pos;
+	key.dest = dest_pos;
+	key.goods_index = wtyp->get_index();
+	if(  const bool *connected = connection_cache.access(key)  ) {
+		return *connected;
+	}
+	const bool connected = search_connection( start_pos, dest_pos, wtyp );
+	connection_cache.put( key, connected );
+	return connected;
+}
+
+
+bool ai_t::search_connection( const koord start_pos, const koord dest_pos, const goods_desc_t *wtyp ) const
 {
 	// Dario: Check if there's a stop near the start
 	const planquadrat_t* start_plan = welt->access(start_pos);
@@ -147,6 +166,7 @@ bool ai_t::call_general_tool( int tool, koord k, const char *param )
 		}
 	}
 	tool_t::general_tool[tool]->set_default_param(old_param);
+	clear_connection_cache();
 	return err==0;
 }
 
@@ -165,6 +185,10 @@ bool ai_t::find_place(koord pos, koord &size, koord *dirs)
 	}
 
 	sint8 start_z = gr->get_hoehe();
+	if(  !welt->can_flatten_tile(this, pos, start_z )  ) {
+		// the same for all tiles of both rotations
+		return false;
+	}
 	int max_dir = length==0 ? 1 : 2;
 	bool place_ok;
 
@@ -175,7 +199,6 @@ bool ai_t::find_place(koord pos, koord &size, koord *dirs)
 			grund_t *gr = welt->lookup_kartenboden(  pos + (dirs[dir]*i)  );
 			if(  gr == NULL
 				||  gr->get_halt().is_bound()
-				||  !welt->can_flatten_tile(this, pos, start_z )
 				||  !gr->ist_natur()
 				||  gr->kann_alle_obj_entfernen(this) != NULL
 				||  gr->get_hoehe() < welt->get_water_hgt( pos + (dirs[dir] * i) )  ) {
@@ -571,6 +594,7 @@ ai_t::ai_t(uint8 nr) : player_t( nr )
 {
 	road_transport = rail_transport = air_transport = ship_transport = false;
 	construction_speed = env_t::default_ai_construction_speed;
+	connection_cache_steps = -1;
 }
 
 
@@ -11,6 +11,7 @@
 
 #include "../finder/building_placefinder.h"
 #include "../descriptor/goods_desc.h"
+#include "../tpl/hashtable_tpl.h"
 
 class karte_t;
 class vehicle_desc_t;
@@ -28,9 +29,54 @@ public:
 };
 
 
+/**
+ * Key of the connections remembered by ai_t::is_connected()
+ */
+struct ai_connection_t
+{
+	koord start;
+	koord dest;
+	uint8 goods_index;
+};
+
+class ai_connection_hash_t
+{
+public:
+	typedef sint64 diff_type;
+
+	static uint32 hash(const ai_connection_t key)
+	{
+		return (uint32)(key.start.x ^ (key.start.y << 8) ^ (key.dest.x << 16) ^ (key.dest.y << 24) ^ key.goods_index);
+	}
+
+	static diff_type comp(const ai_connection_t key1, const ai_connection_t key2)
+	{
+		if(  key1.start != key2.start  ) {
+			return key1.start.x != key2.start.x ? key1.start.x - key2.start.x : key1.start.y - key2.start.y;
+		}
+		if(  key1.dest != key2.dest  ) {
+			return key1.dest.x != key2.dest.x ? key1.dest.x - key2.dest.x : key1.dest.y - key2.dest.y;
+		}
+		return key1.goods_index - key2.goods_index;
+	}
+};
+
+
 // AI helper functions
 class ai_t : public player_t
 {
+private:
+	/**
+	 * The results of is_connected() during this step. The ai plans over the
+	 * same factories and stops many times, but the network only changes with
+	 * a step or with the own construction. Not saved: the cache must always
+	 * give the same answer as a new search, or network games desync.
+	 */
+	mutable hashtable_tpl<ai_connection_t, bool, ai_connection_hash_t, 256> connection_cache;
+	mutable sint32 connection_cache_steps;
+
+	bool search_connection(const koord start_pos, const koord dest_pos, const goods_desc_t *wtyp) const;
+
 protected:
 	// set the allowed modes of transport
 	bool road_transport;
@@ -64,6 +110,9 @@ public:
 	// return true, if there is already a connection
 	bool is_connected(const koord star_pos, const koord end_pos, const goods_desc_t *wtyp) const;
 
+	// forget the connections found in this step, after building something
+	void clear_connection_cache() const { connection_cache.clear(); }
+
 	// calls a general tool just like a human player work do
 	bool call_general_tool( int tool, koord k, const char *param );
 
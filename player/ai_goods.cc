@@ -181,6 +181,10 @@ bool ai_goods_t::get_factory_tree_lowest_missing( fabrik_t *fab )
  */
 int ai_goods_t::get_factory_tree_missing_count( fabrik_t *fab )
 {
+	if(  const sint32 *cached = missing_count_cache.access(fab)  ) {
+		return *cached;
+	}
+
 	int numbers=0; // how many missing?
 
 	factory_desc_t const& d = *fab->get_desc();
@@ -222,9 +226,11 @@ int ai_goods_t::get_factory_tree_missing_count( fabrik_t *fab )
 			}
 		}
 		if(!complete) {
+			missing_count_cache.put( fab, -1 );
 			return -1;
 		}
 	}
+	missing_count_cache.put( fab, numbers );
 	return numbers;
 }
 
@@ -801,6 +807,7 @@ void ai_goods_t::step()
 			if(root==NULL) {
 				// find a tree root to complete
 				weighted_vector_tpl<fabrik_t *> start_fabs(20);
+				missing_count_cache.clear();
 				FOR(vector_tpl<fabrik_t*>, const fab, welt->get_fab_list()) {
 					// consumer and not completely overcrowded
 					if(  fab->get_desc()->is_consumer_only()  &&  fab->get_status() < fabrik_t::bad  ) {
@@ -810,6 +817,7 @@ void ai_goods_t::step()
 						}
 					}
 				}
+				missing_count_cache.clear();
 				if(  !start_fabs.empty()  ) {
 					root = pick_any_weighted(start_fabs);
 				}
@@ -9,6 +9,8 @@
 
 #include "ai.h"
 
+#include "../tpl/ptrhashtable_tpl.h"
+
 
 /// Simple goods transport AI
 class ai_goods_t : public ai_t
@@ -96,6 +98,11 @@ private:
 	 */
 	int get_factory_tree_missing_count( fabrik_t *fab );
 
+	/* the results of get_factory_tree_missing_count() during the search for a root,
+	 * since the suppliers are shared by many consumers
+	 */
+	ptrhashtable_tpl<fabrik_t *, sint32, 256> missing_count_cache;
+
 	bool suche_platz1_platz2(fabrik_t *qfab, fabrik_t *zfab, int length);
 
 	int baue_bahnhof(const koord* p, int vehicle_count);
@@ -56,6 +56,35 @@ SQInteger world_get_halt_by_index(HSQUIRRELVM vm)
 }
 
 
+// all halts with their statistics of one month in one call
+SQInteger world_get_halt_statistics(HSQUIRRELVM vm)
+{
+	sint32 month = param<sint32>::get(vm, 2);
+	if (month < 0  ||  month >= MAX_MONTHS) {
+		return sq_raise_error(vm, "Invalid month %d", month);
+	}
+	const vector_tpl<halthandle_t>& list = haltestelle_t::get_alle_haltestellen();
+	sq_newarray(vm, list.get_count());
+	for(uint32 i = 0; i < list.get_count(); i++) {
+		halthandle_t halt = list[i];
+		sq_pushinteger(vm, i);
+		sq_newtable(vm);
+		create_slot(vm, "halt",        halt);
+		create_slot(vm, "arrived",     halt->get_finance_history(month, HALT_ARRIVED));
+		create_slot(vm, "departed",    halt->get_finance_history(month, HALT_DEPARTED));
+		create_slot(vm, "waiting",     halt->get_finance_history(month, HALT_WAITING));
+		create_slot(vm, "happy",       halt->get_finance_history(month, HALT_HAPPY));
+		create_slot(vm, "unhappy",     halt->get_finance_history(month, HALT_UNHAPPY));
+		create_slot(vm, "noroute",     halt->get_finance_history(month, HALT_NOROUTE));
+		create_slot(vm, "convoys",     halt->get_finance_history(month, HALT_CONVOIS_ARRIVED));
+		create_slot(vm, "too_slow",    halt->get_finance_history(month, HALT_TOO_SLOW));
+		create_slot(vm, "too_waiting", halt->get_finance_history(month, HALT_TOO_WAITING));
+		sq_set(vm, -3);
+	}
+	return 1;
+}
+
+
 SQInteger halt_export_convoy_list(HSQUIRRELVM vm)
 {
 	halthandle_t halt = param<halthandle_t>::get(vm, 1);
@@ -129,6 +158,17 @@ void export_halt(HSQUIRRELVM vm)
 	 * @typemask halt_x()
 	 */
 	register_function(vm, world_get_halt_by_index, "_get",    2, "xi");
+	/**
+	 * Get the statistics of all halts in one call,
+	 * which is much faster than calling the statistics methods of each halt.
+	 * @param month index of the month, 0 corresponds to the current month
+	 * @returns array of tables, one for each halt in the order of this list,
+	 *          with the halt in slot @p halt and the values of the month in slots
+	 *          @p arrived, @p departed, @p waiting, @p happy, @p unhappy, @p noroute,
+	 *          @p convoys, @p too_slow and @p too_waiting (see the respective methods of halt_x).
+	 * @typemask array(integer)
+	 */
+	register_function(vm, world_get_halt_statistics, "get_statistics", 2, "xi");
 	end_class(vm);
 
 	/**
@@ -11,6 +11,9 @@
 #include "../api_function.h"
 #include "../../player/simplay.h"
 #include "../../player/finance.h"
+#include "../../simconvoi.h"
+#include "../../simline.h"
+#include "../../simworld.h"
 
 
 using namespace script_api;
@@ -80,6 +83,42 @@ SQInteger player_export_line_list(HSQUIRRELVM vm)
 	return SQ_ERROR;
 }
 
+// all convoys of the player with their state in one call
+SQInteger player_get_convoy_states(HSQUIRRELVM vm)
+{
+	player_t* player = param<player_t*>::get(vm, 1);
+	if (player == NULL) {
+		return SQ_ERROR;
+	}
+	const vector_tpl<convoihandle_t>& list = welt->convoys();
+	uint32 count = 0;
+	FOR(vector_tpl<convoihandle_t>, const cnv, list) {
+		if (cnv->get_owner() == player) {
+			count++;
+		}
+	}
+	sq_newarray(vm, count);
+	uint32 i = 0;
+	FOR(vector_tpl<convoihandle_t>, const cnv, list) {
+		if (cnv->get_owner() != player) {
+			continue;
+		}
+		sq_pushinteger(vm, i++);
+		sq_newtable(vm);
+		create_slot(vm, "convoy",        cnv);
+		create_slot(vm, "line",          cnv->get_line());
+		create_slot(vm, "pos",           cnv->get_pos());
+		create_slot(vm, "state",         cnv->get_state());
+		create_slot(vm, "speed",         (sint32)speed_to_kmh(cnv->get_akt_speed()));
+		create_slot(vm, "loading_level", cnv->get_loading_level());
+		create_slot(vm, "is_loading",    cnv->is_loading());
+		create_slot(vm, "in_depot",      cnv->in_depot());
+		sq_set(vm, -3);
+	}
+	return 1;
+}
+
+
 void export_player(HSQUIRRELVM vm)
 {
 	/**
@@ -221,6 +260,16 @@ void export_player(HSQUIRRELVM vm)
 	 * @typemask line_list_x()
 	 */
 	register_function(vm, &player_export_line_list, "get_line_list", 1, param<player_t*>::typemask());
+	/**
+	 * Get all convoys of this player with their current state in one call,
+	 * which is much faster than iterating the convoy list and calling methods of each convoy.
+	 * @returns array of tables, one for each convoy, with the slots
+	 *          @p convoy (convoy_x), @p line (line_x or null), @p pos (coord3d),
+	 *          @p state (internal state number), @p speed (current speed in km/h),
+	 *          @p loading_level (percentage), @p is_loading and @p in_depot (bool).
+	 * @typemask array()
+	 */
+	register_function(vm, &player_get_convoy_states, "get_convoy_states", 1, param<player_t*>::typemask());
 
 	end_class(vm);
 }
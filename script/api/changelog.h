@@ -9,6 +9,8 @@
  *
  * @section api-trunk Current trunk
  *
+ * - Added halt_list_x::get_statistics, factory_list_x::get_statistics, player_x::get_convoy_states
+ *
  * @section api-120-1-2 Release 120.1.2
  *
  * - Added label_x::get_text, tile_x::get_text
@@ -13,6 +13,8 @@
 #include "../squirrel/sq_extensions.h" // for sq_call_restricted
 
 #include "../utils/log.h"
+#include "../dataobj/environment.h"
+#include "../sys/simsys.h"
 
 #include "../tpl/vector_tpl.h"
 // for error popups
@@ -33,6 +35,9 @@ static log_t* script_log = NULL;
 // list of active scripts (they share the same log-file, error and print-functions)
 static vector_tpl<script_vm_t*> all_scripts;
 
+// profile entry of the time spent in resuming suspended calls
+#define PROFILE_RESUMED "(resumed calls)"
+
 static void printfunc(HSQUIRRELVM, const SQChar *s, ...)
 {
 	va_list vl;
@@ -42,6 +47,15 @@ static void printfunc(HSQUIRRELVM, const SQChar *s, ...)
 }
 
 
+static void profilefunc(const char *s, ...)
+{
+	va_list vl;
+	va_start(vl, s);
+	script_log->vmessage("Script", "Profile", s, vl);
+	va_end(vl);
+}
+
+
 void script_vm_t::errorfunc(HSQUIRRELVM vm, const SQChar *s_, ...)
 {
 
@@ -114,6 +128,10 @@ script_vm_t::script_vm_t(const char* include_path_)
 
 	error_msg = NULL;
 	include_path = include_path_;
+	profile_function = NULL;
+	if (env_t::script_profiling) {
+		sq_setprofiling(vm, true);
+	}
 	// register libraries
 	sq_pushroottable(vm);
 	sqstd_register_stringlib(vm);
@@ -125,6 +143,7 @@ script_vm_t::script_vm_t(const char* include_path_)
 
 script_vm_t::~script_vm_t()
 {
+	dump_profile();
 	sq_close(vm); // also closes thread
 	all_scripts.remove(this);
 	if (all_scripts.empty()) {
@@ -175,9 +194,53 @@ bool script_vm_t::is_call_suspended(const char* err)
 }
 
 
+void script_vm_t::dump_all_profiles()
+{
+	for(uint32 i=0; i<all_scripts.get_count(); i++) {
+		all_scripts[i]->dump_profile();
+	}
+}
+
+
+static int compare_profile_entries(const void *a, const void *b)
+{
+	const SQProfile::entry_t *ea = *(const SQProfile::entry_t* const*)a;
+	const SQProfile::entry_t *eb = *(const SQProfile::entry_t* const*)b;
+	if (ea->ops != eb->ops) {
+		return ea->ops < eb->ops ? 1 : -1;
+	}
+	return ea->calls < eb->calls ? 1 : (ea->calls > eb->calls ? -1 : 0);
+}
+
+
+void script_vm_t::dump_profile() const
+{
+	const SQProfile *profile = sq_getprofile(vm);
+	if (!env_t::script_profiling  ||  profile == NULL  ||  script_log == NULL) {
+		return;
+	}
+	profilefunc("Script %s", include_path.c_str());
+	profilefunc("%10s %8s %8s  %s", "ms", "calls", "suspends", "called from game");
+	FOR(vector_tpl<profile_call_t>, const& c, profile_calls) {
+		profilefunc("%10u %8u %8u  %s", c.ms, c.calls, c.suspends, c.function.c_str());
+	}
+
+	vector_tpl<const SQProfile::entry_t*> entries(profile->count);
+	for(SQInteger i=0; i<profile->count; i++) {
+		entries.append(profile->entries + i);
+	}
+	qsort(entries.begin(), entries.get_count(), sizeof(const SQProfile::entry_t*), compare_profile_entries);
+	profilefunc("%10s %8s  %s", "ops", "calls", "function");
+	FOR(vector_tpl<const SQProfile::entry_t*>, e, entries) {
+		profilefunc("%10llu %8llu  %s%s", (unsigned long long)e->ops, (unsigned long long)e->calls, e->name, e->native ? " [native]" : "");
+	}
+}
+
+
 const char* script_vm_t::intern_prepare_call(HSQUIRRELVM &job, call_type_t ct, const char* function)
 {
 	const char* err = NULL;
+	profile_function = sq_getprofile(vm) ? function : NULL;
 
 	switch (ct) {
 		case FORCE:
@@ -212,6 +275,17 @@ const char* script_vm_t::intern_prepare_call(HSQUIRRELVM &job, call_type_t ct, c
 
 const char* script_vm_t::intern_finish_call(HSQUIRRELVM job, call_type_t ct, int nparams, bool retvalue)
 {
+	// an index, since nested calls may append to profile_calls
+	uint32 profile = 0;
+	uint32 profile_start = 0;
+	uint32 resume_ms = 0;
+	const bool profiling = profile_function != NULL;
+	if (profiling) {
+		profile = get_profile_call(profile_function);
+		profile_function = NULL;
+		profile_start = dr_time();
+	}
+
 	BEGIN_STACK_WATCH(job);
 	// stack: closure, nparams*objects
 	const char* err = NULL;
@@ -223,7 +297,15 @@ const char* script_vm_t::intern_finish_call(HSQUIRRELVM job, call_type_t ct, int
 		// stack: clean
 	}
 	if (suspended) {
+		const uint32 resume_start = profiling ? dr_time() : 0;
 		intern_resume_call(job);
+		if (profiling) {
+			// the resumed work belongs to an earlier call, not to this one
+			resume_ms = dr_time() - resume_start;
+			profile_call_t &r = profile_calls[get_profile_call(PROFILE_RESUMED)];
+			r.calls++;
+			r.ms += resume_ms;
+		}
 	}
 	if (!suspended  ||  ct == FORCE) {
 		// set active callback if call could be suspended
@@ -238,9 +320,30 @@ const char* script_vm_t::intern_finish_call(HSQUIRRELVM job, call_type_t ct, int
 		END_STACK_WATCH(job,0);
 		err = intern_call_function(job, ct, nparams, retvalue);
 	}
+	if (profiling  &&  profile < profile_calls.get_count()) {
+		profile_call_t &c = profile_calls[profile];
+		c.calls++;
+		c.suspends += is_call_suspended(err);
+		c.ms += dr_time() - profile_start - resume_ms;
+	}
 	return err;
 }
 
+
+uint32 script_vm_t::get_profile_call(const char* function)
+{
+	for(uint32 i = 0; i < profile_calls.get_count(); i++) {
+		if (strcmp(profile_calls[i].function, function) == 0) {
+			return i;
+		}
+	}
+	profile_call_t c;
+	c.function = function;
+	c.calls = c.suspends = c.ms = 0;
+	profile_calls.append(c);
+	return profile_calls.get_count() - 1;
+}
+
 /**
  * Calls function. If it was a queued call, also calls callbacks.
  * Stack(job): expects closure, nparam*objects, on exit: return value (or clean stack if failure).
@@ -14,6 +14,7 @@
 #include "../simtypes.h"
 #include "../squirrel/squirrel.h"
 #include "../utils/plainstring.h"
+#include "../tpl/vector_tpl.h"
 #include <string>
 
 /**
@@ -58,6 +59,12 @@ public:
 	 */
 	static bool is_call_suspended(const char* err);
 
+	/**
+	 * Writes the profiles of all virtual machines to script.log,
+	 * does nothing unless env_t::script_profiling is set.
+	 */
+	static void dump_all_profiles();
+
 #	define prep_function_call() \
 		HSQUIRRELVM job; \
 		const char* err = intern_prepare_call(job, ct, function); \
@@ -184,6 +191,27 @@ private:
 
 	plainstring error_msg;
 
+	/// @{
+	/// @name Profiling of calls from the game to scripted functions
+
+	struct profile_call_t {
+		plainstring function;
+		uint32 calls;     ///< number of calls
+		uint32 suspends;  ///< number of calls that were suspended (or queued)
+		uint32 ms;        ///< time spent in calls, resuming suspended calls is counted in the entry "(resumed calls)"
+	};
+	vector_tpl<profile_call_t> profile_calls;
+
+	/// returns index of the entry of @p function in profile_calls, appends it if missing
+	uint32 get_profile_call(const char* function);
+
+	/// function name of the call being prepared, NULL if not profiling
+	const char* profile_function;
+
+	void dump_profile() const;
+
+	/// @}
+
 	/// @{
 	/// @name Helper functions to call, suspend, queue calls to scripted functions
 
@@ -20,6 +20,7 @@
 #include "simplan.h"
 #include "display/simimg.h"
 #include "vehicle/simroadtraffic.h"
+#include "vehicle/private_car_flow.h"
 #include "simhalt.h"
 #include "simfab.h"
 #include "simcity.h"
@@ -4895,7 +4896,7 @@ void stadt_t::generate_private_cars(koord pos, uint32 journey_tenths_of_minutes,
 						&& (gr->get_weg_ribi_unmasked(road_wt) == ribi_t::northsouth ||
 					       gr->get_weg_ribi_unmasked(road_wt) == ribi_t::eastwest))
 					{
-						if (!private_car_t::list_empty())
+						if (!private_car_t::list_empty() && private_car_flow_t::add_trip(gr->get_pos(), target))
 						{
 							private_car_t* vt = new private_car_t(gr, target);
 							const sint32 time_to_live = ((sint32)journey_tenths_of_minutes * 136584) / (sint32)welt->get_settings().get_meters_per_tile();
@@ -1053,13 +1053,16 @@ void convoi_t::calc_acceleration(uint32 delta_t)
 #endif
 		// Brake for upcoming speed limit?
 		sint32 min_limit = akt_speed; // no need to check limits above min_limit, as it won't lead to further restrictions
-		sint32 steps_from_start = current_info.steps_from_start; // speed has to be reduced before entering the tile. Thus distance from start has to be taken from previous tile.
-		for(i++; i < next_stop_index; i++)
+		// Only a tile with a lower limit than all tiles before it can restrict the speed further,
+		// so follow the chain of such tiles instead of visiting every tile up to the next stop.
+		for(uint32 j = i + 1; j < next_stop_index; j = route_infos.get_element(j).next_lower_limit)
 		{
-			const convoi_t::route_info_t &limit_info = route_infos.get_element(i);
+			const convoi_t::route_info_t &limit_info = route_infos.get_element(j);
 			if(limit_info.speed_limit < min_limit)
 			{
 				min_limit = limit_info.speed_limit;
+				// speed has to be reduced before entering the tile. Thus distance from start has to be taken from previous tile.
+				const sint32 steps_from_start = route_infos.get_element(j - 1).steps_from_start;
 				const sint32 limit_steps = brake_steps - calc_min_braking_distance(welt->get_settings(), get_weight_summary(), limit_info.speed_limit);
 				const sint32 route_steps = route_infos.calc_steps(current_info.steps_from_start, steps_from_start);
 				const sint32 st = route_steps - limit_steps;
@@ -1070,11 +1073,10 @@ void convoi_t::calc_acceleration(uint32 delta_t)
 					steps_til_limit = route_steps;
 					steps_til_brake = st;
 #ifdef DEBUG_ACCELERATION
-					dbg->warning("convoi_t::calc_acceleration 2", debug_fmt1, current_route_index - 1, i, speed_to_kmh(next_speed_limit), speed_to_kmh(akt_speed), steps_til_brake, steps_til_limit);
+					dbg->warning("convoi_t::calc_acceleration 2", debug_fmt1, current_route_index - 1, j, speed_to_kmh(next_speed_limit), speed_to_kmh(akt_speed), steps_til_brake, steps_til_limit);
 #endif
 				}
 			}
-			steps_from_start = limit_info.steps_from_start;
 		}
 	}
 	else
@@ -1154,6 +1156,7 @@ convoi_t::route_infos_t& convoi_t::get_route_infos()
 		sint32 takeoff_index = front.get_takeoff_route_index();
 		sint32 touchdown_index = front.get_touchdown_route_index();
 		uint32 bridge_tiles = 0;
+		uint32 bridge_length = 0; // bridge tiles from the first tile of the current bridge on
 		for (i++; i < route_count; i++)
 		{
 			convoi_t::route_info_t &current_info = route_infos.get_element(i - 1);
@@ -1169,19 +1172,25 @@ convoi_t::route_infos_t& convoi_t::get_route_infos()
 			{
 				bridge_tiles++;
 
-				for (uint32 j = i + 1; j < route_count; j++)
+				if (bridge_tiles == 1)
 				{
-					const koord3d tile = route.at(j);
-					const grund_t* gr = welt->lookup(tile);
-					if (gr && gr->ist_bruecke())
+					// count the length of this bridge once when entering it
+					bridge_length = 1;
+					for (uint32 j = i + 1; j < route_count; j++)
 					{
-						bridge_tiles_ahead++;
-					}
-					else
-					{
-						break;
+						const koord3d tile = route.at(j);
+						const grund_t* gr = welt->lookup(tile);
+						if (gr && gr->ist_bruecke())
+						{
+							bridge_length++;
+						}
+						else
+						{
+							break;
+						}
 					}
 				}
+				bridge_tiles_ahead = bridge_length - bridge_tiles;
 			}
 			else
 			{
@@ -1199,6 +1208,18 @@ convoi_t::route_infos_t& convoi_t::get_route_infos()
 		}
 		route_infos.set_holding_pattern_indexes(current_route_index, touchdown_index);
 
+		// link each tile to the next one with a lower speed limit
+		vector_tpl<uint32> lower_limits;
+		for (uint32 j = route_count; j-- > 0; )
+		{
+			convoi_t::route_info_t &info = route_infos.get_element(j);
+			while (!lower_limits.empty() && route_infos.get_element(lower_limits.back()).speed_limit >= info.speed_limit)
+			{
+				lower_limits.pop_back();
+			}
+			info.next_lower_limit = lower_limits.empty() ? route_count : lower_limits.back();
+			lower_limits.append(j);
+		}
 	}
 	return route_infos;
 }
@@ -7304,20 +7325,17 @@ bool convoi_t::can_overtake(overtaker_t *other_overtaker, sint32 other_speed, si
 			}
 			if(  overtaking_mode>oneway_mode  ) {
 				// Check for other vehicles on the next tile
-				const uint8 top = gr->get_top();
-				for (uint8 j = 1; j < top; j++) {
-					if (vehicle_base_t* const v = obj_cast<vehicle_base_t>(gr->obj_bei(j))) {
-						// check for other traffic on the road
-						const overtaker_t *ov = v->get_overtaker();
-						if (ov) {
-							if (this != ov  &&  other_overtaker != ov) {
-								return false;
-							}
-						}
-						else if (v->get_waytype() == road_wt  &&  v->get_typ() != obj_t::pedestrian) {
+				FOR(minivec_tpl<vehicle_base_t *>, const v, strasse_t::get_road_users(gr)) {
+					// check for other traffic on the road
+					const overtaker_t *ov = v->get_overtaker();
+					if (ov) {
+						if (this != ov  &&  other_overtaker != ov) {
 							return false;
 						}
 					}
+					else {
+						return false;
+					}
 				}
 			}
 		}
@@ -7436,30 +7454,26 @@ bool convoi_t::can_overtake(overtaker_t *other_overtaker, sint32 other_speed, si
 		time_overtaking += d;
 
 		// Check for other vehicles
-		const uint8 top = gr->get_top();
-		for(  uint8 j=1;  j<top;  j++ ) {
-			if (vehicle_base_t* const v = obj_cast<vehicle_base_t>(gr->obj_bei(j))) {
-				// check for other traffic on the road
-				const overtaker_t *ov = v->get_overtaker();
-				if(ov) {
-					if(this!=ov  &&  other_overtaker!=ov) {
-						if(  overtaking_mode_loop <= oneway_mode  ) {
-							//If ov goes same directory, should not return false
-							ribi_t::ribi their_direction = ribi_t::backward( front()->calc_direction(pos_prev, pos_next) );
-							vehicle_base_t* const v = obj_cast<vehicle_base_t>(gr->obj_bei(j));
-							if (v && v->get_direction() == their_direction && v->get_overtaker()) {
-								return false;
-							}
-						}
-						else {
+		FOR(minivec_tpl<vehicle_base_t *>, const v, strasse_t::get_road_users(gr)) {
+			// check for other traffic on the road
+			const overtaker_t *ov = v->get_overtaker();
+			if(ov) {
+				if(this!=ov  &&  other_overtaker!=ov) {
+					if(  overtaking_mode_loop <= oneway_mode  ) {
+						//If ov goes same directory, should not return false
+						ribi_t::ribi their_direction = ribi_t::backward( front()->calc_direction(pos_prev, pos_next) );
+						if (v->get_direction() == their_direction && v->get_overtaker()) {
 							return false;
 						}
 					}
+					else {
+						return false;
+					}
 				}
-				else if(  v->get_waytype()==road_wt  &&  v->get_typ()!=obj_t::pedestrian  ) {
-					// sheeps etc.
-					return false;
-				}
+			}
+			else {
+				// sheeps etc.
+				return false;
 			}
 		}
 		n_tiles++;
@@ -7509,10 +7523,8 @@ bool convoi_t::can_overtake(overtaker_t *other_overtaker, sint32 other_speed, si
 
 		// Check for other vehicles in facing direction
 		ribi_t::ribi their_direction = ribi_t::backward( front()->calc_direction(pos_prev, pos_next) );
-		const uint8 top = gr->get_top();
-		for(  uint8 j=1;  j<top;  j++ ) {
-			vehicle_base_t* const v = obj_cast<vehicle_base_t>(gr->obj_bei(j));
-			if (v && v->get_direction() == their_direction && v->get_overtaker()) {
+		FOR(minivec_tpl<vehicle_base_t *>, const v, strasse_t::get_road_users(gr)) {
+			if (v->get_direction() == their_direction && v->get_overtaker()) {
 				return false;
 			}
 		}
@@ -8242,10 +8254,9 @@ float32e8_t convoi_t::get_brake_summary(/*const float32e8_t &speed*/ /* in m/s *
 }
 
 
-float32e8_t convoi_t::get_force_summary(const float32e8_t &speed /* in m/s */)
+float32e8_t convoi_t::calc_force_summary(sint32 v, uint16 force_factor)
 {
 	sint64 force = 0;
-	sint32 v = speed;
 
 	for (const_iterator i = begin(); i != end(); ++i )
 	{
@@ -8255,7 +8266,57 @@ float32e8_t convoi_t::get_force_summary(const float32e8_t &speed /* in m/s */)
 	//for (array_tpl<vehicle_t*>::iterator i = vehicle.begin(), n = i + get_vehicle_count(); i != n; ++i)
 	//	force += (*i)->get_desc()->get_effective_force_index(v);
 
-	return power_index_to_power(force, welt->get_settings().get_global_force_factor_percent());
+	return power_index_to_power(force, force_factor);
+}
+
+
+// highest speed in m/s covered by the force table
+#define MAX_FORCE_TABLE_SPEED (1023)
+
+void convoi_t::update_force_table(uint16 force_factor)
+{
+	is_valid |= cd_force_table;
+	force_table_factor = force_factor;
+	force_table.clear();
+	if (get_vehicle_count() == 0)
+	{
+		return;
+	}
+	// Each vehicle's force stays the same above its own top speed,
+	// so the table needs only to reach the top speed of the fastest.
+	uint32 max_speed = 0;
+	for (const_iterator i = begin(); i != end(); ++i )
+	{
+		max_speed = max(max_speed, (uint32)(*i)->get_desc()->get_topspeed());
+	}
+	const uint32 count = min((max_speed * 1000 + 3599) / 3600 + 2, (uint32)MAX_FORCE_TABLE_SPEED + 1);
+	force_table.resize(count);
+	for (uint32 v = 0; v < count; v++)
+	{
+		force_table.append(calc_force_summary(v, force_factor));
+	}
+}
+
+
+float32e8_t convoi_t::get_force_summary(const float32e8_t &speed /* in m/s */)
+{
+	const sint32 v = speed;
+	const uint16 force_factor = welt->get_settings().get_global_force_factor_percent();
+	if (!(is_valid & cd_force_table) || force_table_factor != force_factor)
+	{
+		update_force_table(force_factor);
+	}
+	if (v < 0 || (uint32)v >= force_table.get_count())
+	{
+		return calc_force_summary(v, force_factor);
+	}
+#ifdef DEBUG_FORCE_TABLE
+	if (force_table[v] != calc_force_summary(v, force_factor))
+	{
+		dbg->error("convoi_t::get_force_summary()", "force table of %s differs at %d m/s", get_name(), v);
+	}
+#endif
+	return force_table[v];
 }
 
 
@@ -21,6 +21,7 @@
 #include "tpl/array_tpl.h"
 #include "tpl/fixed_list_tpl.h"
 #include "tpl/koordhashtable_tpl.h"
+#include "tpl/koordmap_tpl.h"
 #include "tpl/inthashtable_tpl.h"
 #include "tpl/minivec_tpl.h"
 
@@ -54,7 +55,7 @@ class departure_point_t;
 * The table of point-to-point average journey times.
 * @author jamespetts
 */
-typedef koordhashtable_tpl<id_pair, average_tpl<uint32>, N_BAGS_SMALL> journey_times_map;
+typedef koordmap_tpl<id_pair, average_tpl<uint32> > journey_times_map;
 
 #ifdef MULTI_THREAD
 struct route_range_specification
@@ -223,6 +224,15 @@ private:
 	weight_summary_t weight;
 	static const sint32 timings_reduction_point = 6;
 	bool re_ordered; // Whether this convoy's vehicles are currently arranged in reverse order.
+
+	// Force in N at each whole speed in m/s up to the maximum speed, as returned by get_force_summary().
+	// Valid if (is_valid & cd_force_table) and made with the current global force factor.
+	vector_tpl<float32e8_t> force_table;
+	uint16 force_table_factor;
+
+	// Sum of the vehicles' forces at speed v in m/s
+	float32e8_t calc_force_summary(sint32 v, uint16 force_factor);
+	void update_force_table(uint16 force_factor);
 protected:
 	virtual void update_vehicle_summary(vehicle_summary_t &vehicle) OVERRIDE;
 	virtual void update_freight_summary(freight_summary_t &freight) OVERRIDE;
@@ -585,7 +595,7 @@ private:
 	* convoy will arrive at each stop in its schedule by concatenating
 	* strings of these and adding the waiting time for each stop.
 	*/
-	typedef koordhashtable_tpl<departure_point_t, average_tpl<uint16>, N_BAGS_SMALL> timings_map;
+	typedef koordmap_tpl<departure_point_t, average_tpl<uint16> > timings_map;
 	timings_map journey_times_between_schedule_points;
 
 	// @author: suitougreentea
@@ -717,6 +727,7 @@ public:
 	public:
 		sint32 speed_limit;
 		uint32 steps_from_start; // steps including this tile's length, which is VEHICLE_STEPS_PER_TILE for a straight way and diagonal_vehicle_steps_per_tile for a diagonal way.
+		uint32 next_lower_limit; // index of the next tile with a lower speed_limit or the route's length, if there is none.
 		ribi_t::ribi direction;
 	};
 
@@ -1128,7 +1139,7 @@ public:
 	sint32 get_max_signal_speed() const { return max_signal_speed; }
 
 	inline void set_wait_lock(sint32 value) { wait_lock = value; }
-	inline sint32 get_wait_lock() { return wait_lock; }
+	inline sint32 get_wait_lock() const { return wait_lock; }
 
 	bool check_destination_reverse(route_t* current_route = NULL, route_t* target_rt = NULL);
 
@@ -75,11 +75,16 @@ inthashtable_tpl<sint32,halthandle_t,N_BAGS_LARGE> *haltestelle_t::all_koords =
 //uint8 haltestelle_t::status_step = 0;
 uint8 haltestelle_t::reconnect_counter = 0;
 
+vector_tpl<halthandle_t> haltestelle_t::halts_to_reroute;
+
 // controls the halt iterator in step_all():
 static bool restart_halt_iterator = true;
 
 void haltestelle_t::step_all()
 {
+	// re-route the goods of all halts asked for by the path explorer
+	reroute_goods_all();
+
 	const uint32 count = alle_haltestellen.get_count();
 	if (count)
 	{
@@ -376,6 +381,7 @@ void haltestelle_t::destroy_all()
 	}
 	delete all_koords;
 	all_koords = NULL;
+	halts_to_reroute.clear();
 	//status_step = 0;
 }
 
@@ -389,6 +395,7 @@ haltestelle_t::haltestelle_t(loadsave_t* file)
 	const uint8 max_classes = max(goods_manager_t::passengers->get_number_of_classes(), goods_manager_t::mail->get_number_of_classes());
 
 	cargo = (vector_tpl<ware_t> **)calloc( max_categories, sizeof(vector_tpl<ware_t> *) );
+	cargo_index = (cargo_index_t **)calloc( max_categories, sizeof(cargo_index_t *) );
 
 	non_identical_schedules.set_count(max_categories * max_classes);
 	// CHECK: Do we need the below in light of the above? Does the above auto-initialise the values to zero?
@@ -466,6 +473,7 @@ haltestelle_t::haltestelle_t(koord k, player_t* player)
 	const uint8 max_classes = max(goods_manager_t::passengers->get_number_of_classes(), goods_manager_t::mail->get_number_of_classes());
 
 	cargo = (vector_tpl<ware_t> **)calloc( max_categories, sizeof(vector_tpl<ware_t> *) );
+	cargo_index = (cargo_index_t **)calloc( max_categories, sizeof(cargo_index_t *) );
 
 	non_identical_schedules.set_count(max_categories * max_classes);
 	// CHECK: Do we need the below in light of the above? Does the above auto-initialise the values to zero?
@@ -631,6 +639,17 @@ haltestelle_t::~haltestelle_t()
 	destroy_win( magic_halt_info + self.get_id() );
 	destroy_win( magic_halt_detail + self.get_id() );
 
+#ifdef MULTI_THREAD
+	// the path explorer may queue this halt for re-routing meanwhile
+	welt->await_path_explorer();
+#endif
+
+	// the handle might be reused before the next re-routing
+	if (!categories_to_refresh_next_step.empty())
+	{
+		halts_to_reroute.remove(self);
+	}
+
 	// finally detach handle
 	// before it is needed for clearing up the planqudrat and tiles
 	self.detach();
@@ -645,12 +664,10 @@ haltestelle_t::~haltestelle_t()
 			delete cargo[i];
 			cargo[i] = NULL;
 		}
+		invalidate_cargo_index(i);
 	}
 	free(cargo);
-
-#ifdef MULTI_THREAD
-	welt->await_path_explorer();
-#endif
+	free(cargo_index);
 
 	if (!welt->is_destroying())
 	{
@@ -698,6 +715,7 @@ void haltestelle_t::rotate90( const sint16 y_size )
 					warray.remove_at(j);
 				}
 			}
+			invalidate_cargo_index(i);
 		}
 	}
 
@@ -1269,12 +1287,6 @@ void haltestelle_t::step()
 
 	PIXVAL old_status_color = status_color;
 
-	FOR(vector_tpl<uint8>, catg, categories_to_refresh_next_step)
-	{
-		reroute_goods(catg);
-	}
-	categories_to_refresh_next_step.clear();
-
 	check_transferring_cargoes();
 
 	recalc_status();
@@ -1509,6 +1521,14 @@ void haltestelle_t::new_month()
  * returns true upon completion
  */
 uint32 haltestelle_t::reroute_goods(const uint8 catg)
+{
+	const uint32 packet_count = reroute_goods_intern(catg);
+	finish_reroute_goods();
+	return packet_count;
+}
+
+
+uint32 haltestelle_t::reroute_goods_intern(const uint8 catg)
 {
 	if(cargo[catg])
 	{
@@ -1557,8 +1577,7 @@ uint32 haltestelle_t::reroute_goods(const uint8 catg)
 			   && !get_preferred_convoy(ware.get_zwischenziel(), 0, ware.get_class()).is_bound()
 			   && !get_preferred_line(ware.get_zwischenziel(), 0, ware.get_class()).is_bound())
 			{
-				pedestrian_t::generate_pedestrians_at(get_basis_pos3d(), ware.menge);
-				ware.get_zwischenziel()->liefere_an(ware, 1); // start counting walking steps at 1 again
+				rerouted_walking.append(ware);
 				continue;
 			}
 
@@ -1578,23 +1597,13 @@ uint32 haltestelle_t::reroute_goods(const uint8 catg)
 					// no connections from here => delete
 					delete new_warray;
 					new_warray = NULL;
-					ware_t ware;
 
 					for (uint32 i = 0; i < packet_count; i++)
 					{
-						ware = warray->get_element(i);
+						const ware_t &ware = warray->get_element(i);
 						if (ware.is_freight())
 						{
-							const grund_t* gr = welt->lookup_kartenboden(ware.get_zielpos());
-							if (gr)
-							{
-								const gebaeude_t* building = gr->get_building();
-								const fabrik_t* fab = building ? building->get_fabrik() : NULL;
-								if (fab)
-								{
-									fab->update_transit(ware, false);
-								}
-							}
+							rerouted_discarded.append(ware);
 						}
 					}
 				}
@@ -1604,6 +1613,7 @@ uint32 haltestelle_t::reroute_goods(const uint8 catg)
 		// replace the array
 		delete cargo[catg];
 		cargo[catg] = new_warray;
+		invalidate_cargo_index(catg);
 
 		// likely the display must be updated after this
 		resort_freight_info = true;
@@ -1616,6 +1626,208 @@ uint32 haltestelle_t::reroute_goods(const uint8 catg)
 	}
 }
 
+void haltestelle_t::finish_reroute_goods()
+{
+	FOR(vector_tpl<ware_t>, const& ware, rerouted_walking)
+	{
+		pedestrian_t::generate_pedestrians_at(get_basis_pos3d(), ware.menge);
+		ware.get_zwischenziel()->liefere_an(ware, 1); // start counting walking steps at 1 again
+	}
+	rerouted_walking.clear();
+
+	FOR(vector_tpl<ware_t>, const& ware, rerouted_discarded)
+	{
+		const grund_t* gr = welt->lookup_kartenboden(ware.get_zielpos());
+		if (gr)
+		{
+			const gebaeude_t* building = gr->get_building();
+			const fabrik_t* fab = building ? building->get_fabrik() : NULL;
+			if (fab)
+			{
+				fab->update_transit(ware, false);
+			}
+		}
+	}
+	rerouted_discarded.clear();
+}
+
+
+void haltestelle_t::set_reroute_goods_next_step(uint8 catg)
+{
+	if (categories_to_refresh_next_step.empty())
+	{
+		halts_to_reroute.append(self);
+	}
+	categories_to_refresh_next_step.append(catg);
+}
+
+
+// at most this many halts are re-routed per step, the same on all clients
+#define MAX_HALTS_REROUTED_PER_STEP (256)
+
+#ifdef MULTI_THREAD
+// fewer halts than this are re-routed by the main thread alone
+#define MIN_HALTS_PER_REROUTE_THREAD (4)
+
+struct reroute_goods_param_t
+{
+	uint32 first;
+	uint32 step;
+	uint32 count;
+};
+
+
+void *haltestelle_t::reroute_goods_threaded(void *args)
+{
+	const reroute_goods_param_t *param = (const reroute_goods_param_t *)args;
+	for (uint32 i = param->first; i < param->count; i += param->step)
+	{
+		const halthandle_t halt = halts_to_reroute[i];
+		if (halt.is_bound())
+		{
+			FOR(vector_tpl<uint8>, catg, halt->categories_to_refresh_next_step)
+			{
+				halt->reroute_goods_intern(catg);
+			}
+			halt->categories_to_refresh_next_step.clear();
+		}
+	}
+	return NULL;
+}
+#endif
+
+
+void haltestelle_t::reroute_goods_all()
+{
+	if (halts_to_reroute.empty())
+	{
+		return;
+	}
+
+	// The rest waits for the next steps, so a large refresh does not stall a single step.
+	const uint32 count = min(halts_to_reroute.get_count(), (uint32)MAX_HALTS_REROUTED_PER_STEP);
+
+	// First, these halts re-route their own goods: this only reads the routing
+	// data of the path explorer and writes to the halt itself.
+#ifdef MULTI_THREAD
+	const uint32 num_threads = min((uint32)env_t::num_threads, count / MIN_HALTS_PER_REROUTE_THREAD);
+	if (num_threads > 1)
+	{
+		pthread_t thread[MAX_THREADS];
+		reroute_goods_param_t param[MAX_THREADS];
+		for (uint32 t = 0; t < num_threads; t++)
+		{
+			param[t].first = t;
+			param[t].step = num_threads;
+			param[t].count = count;
+		}
+		uint32 spawned = 1;
+		for (; spawned < num_threads; spawned++)
+		{
+			if (pthread_create(&thread[spawned], NULL, reroute_goods_threaded, (void *)&param[spawned]))
+			{
+				break;
+			}
+		}
+		reroute_goods_threaded(&param[0]);
+		for (uint32 t = 1; t < spawned; t++)
+		{
+			pthread_join(thread[t], NULL);
+		}
+		// if thread creation failed, do the rest ourselves
+		for (uint32 t = spawned; t < num_threads; t++)
+		{
+			reroute_goods_threaded(&param[t]);
+		}
+	}
+	else
+#endif
+	{
+		for (uint32 i = 0; i < count; i++)
+		{
+			const halthandle_t halt = halts_to_reroute[i];
+			if (halt.is_bound())
+			{
+				FOR(vector_tpl<uint8>, catg, halt->categories_to_refresh_next_step)
+				{
+					halt->reroute_goods_intern(catg);
+				}
+				halt->categories_to_refresh_next_step.clear();
+			}
+		}
+	}
+
+	// Then the goods which leave for other halts or are discarded are handed over
+	// in a fixed order.
+	for (uint32 i = 0; i < count; i++)
+	{
+		const halthandle_t halt = halts_to_reroute[i];
+		if (halt.is_bound())
+		{
+			halt->finish_reroute_goods();
+		}
+	}
+
+	// keep the order of the remaining halts
+	const uint32 remaining = halts_to_reroute.get_count() - count;
+	for (uint32 i = 0; i < remaining; i++)
+	{
+		halts_to_reroute[i] = halts_to_reroute[count + i];
+	}
+	halts_to_reroute.set_count(remaining);
+}
+
+
+void haltestelle_t::rdwr_reroute_queue(loadsave_t *file)
+{
+	if (file->is_loading())
+	{
+		// replaces whatever the routing refresh after loading has queued
+		FOR(vector_tpl<halthandle_t>, const halt, halts_to_reroute)
+		{
+			if (halt.is_bound())
+			{
+				halt->categories_to_refresh_next_step.clear();
+			}
+		}
+		halts_to_reroute.clear();
+	}
+
+	uint32 count = halts_to_reroute.get_count();
+	file->rdwr_long(count);
+	for (uint32 i = 0; i < count; i++)
+	{
+		halthandle_t halt;
+		uint16 id = 0;
+		uint8 catg_count = 0;
+		if (file->is_saving())
+		{
+			halt = halts_to_reroute[i];
+			if (halt.is_bound())
+			{
+				id = halt.get_id();
+				catg_count = (uint8)halt->categories_to_refresh_next_step.get_count();
+			}
+		}
+		file->rdwr_short(id);
+		file->rdwr_byte(catg_count);
+		if (file->is_loading())
+		{
+			halt.set_id(id);
+		}
+		for (uint8 j = 0; j < catg_count; j++)
+		{
+			uint8 catg = file->is_saving() ? halt->categories_to_refresh_next_step[j] : 0;
+			file->rdwr_byte(catg);
+			if (file->is_loading() && halt.is_bound())
+			{
+				halt->set_reroute_goods_next_step(catg);
+			}
+		}
+	}
+}
+
+
 void haltestelle_t::add_factory(fabrik_t* fab)
 {
 	fab_list.append_unique(fab);
@@ -2346,6 +2558,91 @@ bool haltestelle_t::recall_ware( ware_t& w, uint32 menge )
 }
 
 
+void haltestelle_t::add_to_cargo_index(cargo_index_t *index, uint8 catg, uint32 pos)
+{
+	const ware_t &ware = (*cargo[catg])[pos];
+	const halthandle_t halts[3] = { halthandle_t(), ware.get_zwischenziel(), ware.get_ziel() };
+
+	for(uint8 i = 0; i < 3; i++)
+	{
+		if(i > 0 && (!halts[i].is_bound() || (i == 2 && halts[2] == halts[1])))
+		{
+			continue;
+		}
+		const uint32 key = get_cargo_index_key(halts[i], ware.get_class());
+		index->groups.put(key);
+		index->groups.access(key)->append(pos);
+		index->entries++;
+	}
+}
+
+
+haltestelle_t::cargo_index_t *haltestelle_t::get_cargo_index(uint8 catg)
+{
+	const vector_tpl<ware_t> *warray = cargo[catg];
+	cargo_index_t *index = cargo_index[catg];
+	// Reused slots leave stale entries behind: start afresh once they dominate.
+	if(index && index->entries > warray->get_count() * 4 + 64)
+	{
+		invalidate_cargo_index(catg);
+		index = NULL;
+	}
+	if(index == NULL)
+	{
+		index = new cargo_index_t();
+		for(uint32 i = 0; i < warray->get_count(); i++)
+		{
+			if((*warray)[i].menge > 0)
+			{
+				add_to_cargo_index(index, catg, i);
+			}
+		}
+		cargo_index[catg] = index;
+	}
+	return index;
+}
+
+
+void haltestelle_t::invalidate_cargo_index(uint8 catg)
+{
+	delete cargo_index[catg];
+	cargo_index[catg] = NULL;
+}
+
+
+void haltestelle_t::remove_empty_ware(uint8 catg, uint32 pos)
+{
+	vector_tpl<ware_t> *warray = cargo[catg];
+	const uint32 last = warray->get_count() - 1;
+	cargo_index_t *const index = cargo_index[catg];
+	if(index && pos != last)
+	{
+		// The last packet moves into this slot: move its entries with it.
+		// The entries of the removed packet become stale and are filtered out.
+		const ware_t &moved = (*warray)[last];
+		const halthandle_t halts[3] = { halthandle_t(), moved.get_zwischenziel(), moved.get_ziel() };
+		for(uint8 i = 0; i < 3; i++)
+		{
+			if(i > 0 && (!halts[i].is_bound() || (i == 2 && halts[2] == halts[1])))
+			{
+				continue;
+			}
+			if(vector_tpl<uint32> *group = index->groups.access(get_cargo_index_key(halts[i], moved.get_class())))
+			{
+				FOR(vector_tpl<uint32>, & entry, *group)
+				{
+					if(entry == last)
+					{
+						entry = pos;
+					}
+				}
+			}
+		}
+	}
+	warray->remove_at(pos, false);
+}
+
+
 bool haltestelle_t::fetch_goods(slist_tpl<ware_t> &load, const goods_desc_t *good_category, sint32 requested_amount, const schedule_t *schedule, const player_t *player, convoi_t* cnv, bool overcrowded, const uint8 g_class, const bool use_lower_classes, bool& other_classes_available, const bool mixed_load_prohibition, uint8 goods_restriction)
 {
 	bool skipped = false;
@@ -2353,35 +2650,137 @@ bool haltestelle_t::fetch_goods(slist_tpl<ware_t> &load, const goods_desc_t *goo
 	vector_tpl<ware_t> *warray = cargo[catg_index];
 	if(warray && warray->get_count() > 0)
 	{
-		binary_heap_tpl<ware_t*> goods_to_check;
-		for(uint32 i = 0;  i < warray->get_count();  )
+		// There is no need any longer to have empty ware packets hanging around.
+		for(uint32 i = 0; i < warray->get_count(); )
 		{
-			// Load first the goods/passengers/mail that have been waiting the longest.
-			// Do this by adding them all to a binary heap sorted by arrival time.
-			ware_t* const ware = &(*warray)[i];
-			if(ware->menge > 0)
+			if((*warray)[i].menge > 0)
 			{
 				i++;
-				if (ware->get_class() >= g_class)
+			}
+			else
+			{
+				remove_empty_ware(catg_index, i);
+			}
+		}
+
+		cargo_index_t *const waiting_index = get_cargo_index(catg_index);
+		const uint8 number_of_classes = goods_manager_t::get_classes_catg_index(catg_index);
+
+		// We know at this stage that we cannot load passengers of a *lower* class into higher class accommodation,
+		// but we cannot yet know whether or not to load passengers of a higher class into lower class accommodation.
+		// Note that this method is called for each class of accommodation in each vehicle in each convoy.
+		for(uint8 c = 0; c < g_class && !other_classes_available; c++)
+		{
+			const vector_tpl<uint32> *group = waiting_index->groups.access(get_cargo_index_key(halthandle_t(), c));
+			if(group)
+			{
+				FOR(vector_tpl<uint32>, const pos, *group)
 				{
-					// We know at this stage that we cannot load passengers of a *lower* class into higher class accommodation,
-					// but we cannot yet know whether or not to load passengers of a higher class into lower class accommodation.
-					// Note that this method is called for each class of accommodation in each vehicle in each convoy.
-					goods_to_check.insert(ware);
+					if(pos >= warray->get_count())
+					{
+						continue;
+					}
+					const ware_t &ware = (*warray)[pos];
+					if(ware.menge > 0 && ware.get_class() == c)
+					{
+						other_classes_available = true;
+						break;
+					}
 				}
-				else
+			}
+		}
+
+		halthandle_t cached_halts[256];
+
+		// Arrival estimates by (halt, next transfer or destination, class) for this convoy
+		struct arrival_estimate_t
+		{
+			sint64 best_arrival_time;
+			sint64 this_arrival_time;
+			convoihandle_t fast_convoy;
+		};
+		inthashtable_tpl<uint32, arrival_estimate_t, N_BAGS_SMALL> arrival_estimates;
+		// Faster convoys which are not worth waiting for, by convoy id
+		inthashtable_tpl<uint16, bool, N_BAGS_SMALL> pointless_to_wait_for_convoy;
+
+		// Only packets bound for a stop on the way ahead (either as next transfer or as
+		// destination) can board. Collect these stops once: the walk below is the same
+		// as the one done per packet, but without the early exits, so it covers every
+		// stop that any packet could be checked against.
+		vector_tpl<halthandle_t> halts_ahead;
+		{
+			uint8 index = schedule->get_current_stop();
+			bool reverse = cnv->get_reverse_schedule();
+			if(cnv->get_state() != convoi_t::REVERSING)
+			{
+				schedule->increment_index(&index, &reverse);
+			}
+
+			int count = 0;
+			for(int steps = 0; steps <= schedule->get_count() * 2 && (index != schedule->get_current_stop() || (cnv->get_state() == convoi_t::REVERSING && count == 0)); steps++)
+			{
+				halthandle_t& schedule_halt = cached_halts[index];
+				if(schedule_halt.is_null())
+				{
+					schedule_halt = haltestelle_t::get_halt(schedule->entries[index].pos, player);
+				}
+
+				if(schedule_halt == self)
 				{
-					other_classes_available = true;
+					if(count == 0)
+					{
+						schedule->increment_index(&index, &reverse);
+						continue;
+					}
+					break;
 				}
+
+				count ++;
+				if(schedule_halt.is_bound())
+				{
+					halts_ahead.append_unique(schedule_halt);
+				}
+				schedule->increment_index(&index, &reverse);
 			}
-			else
+		}
+
+		// Positions of the packets to check, in storage order
+		vector_tpl<uint32> candidates;
+		FOR(vector_tpl<halthandle_t>, const halt, halts_ahead)
+		{
+			for(uint8 c = g_class; c < number_of_classes; c++)
 			{
-				// There is no need any longer to have empty ware packets hanging around.
-				warray->remove_at(i, false);
+				const vector_tpl<uint32> *group = waiting_index->groups.access(get_cargo_index_key(halt, c));
+				if(group)
+				{
+					FOR(vector_tpl<uint32>, const pos, *group)
+					{
+						if(pos >= warray->get_count())
+						{
+							// stale entry of a removed packet
+							continue;
+						}
+						const ware_t &ware = (*warray)[pos];
+						if(ware.menge > 0 && ware.get_class() == c && (ware.get_zwischenziel() == halt || ware.get_ziel() == halt))
+						{
+							candidates.append(pos);
+						}
+					}
+				}
 			}
 		}
+		std::sort(candidates.begin(), candidates.end());
 
-		halthandle_t cached_halts[256];
+		// Load first the goods/passengers/mail that have been waiting the longest.
+		// Do this by adding them all to a binary heap sorted by arrival time.
+		binary_heap_tpl<ware_t*> goods_to_check;
+		for(uint32 i = 0; i < candidates.get_count(); i++)
+		{
+			if(i == 0 || candidates[i] != candidates[i - 1])
+			{
+				goods_to_check.insert(&(*warray)[candidates[i]]);
+			}
+		}
 
 
 		while(!goods_to_check.empty())
@@ -2429,43 +2828,55 @@ bool haltestelle_t::fetch_goods(slist_tpl<ware_t> &load, const goods_desc_t *goo
 				if(schedule_halt.is_bound() && (bound_for_next_transfer || bound_for_destination) && schedule_halt->is_enabled(catg_index))
 				{
 
-					// Check to see whether this is the convoy departing from this stop that will arrive at the next transfer or ultimate destination the soonest.
-					convoihandle_t fast_convoy;
-					sint64 best_arrival_time;
-					if (bound_for_next_transfer)
-					{
-						best_arrival_time = calc_earliest_arrival_time_at(next_transfer, fast_convoy, catg_index, next_to_load->g_class);
-					}
-					else
-					{
-						// This should be called only relatively rarely, when a convoy bound for this packet's ultimate destination arrives,
-						// but this convoy is routed via an intermediate halt. Check whether it is sensible to stick to the planned route
-						// here.
-						uint32 test_time = 0;
-						halthandle_t test_transfer;
-						path_explorer_t::get_catg_path_between(catg_index, self, destination, test_time, test_transfer, next_to_load->g_class);
-						const sint64 test_time_in_ticks = welt->get_seconds_to_ticks(test_time * 6);
-						best_arrival_time = test_time_in_ticks + welt->get_ticks();
-					}
-
 					const halthandle_t check_halt = bound_for_next_transfer ? next_transfer : destination;
 
-					const arrival_times_map& check_arrivals = check_halt->get_estimated_convoy_arrival_times();
-					sint64 this_arrival_time = check_arrivals.get(cnv->self.get_id());
-					if (this_arrival_time == 0)
+					// The estimates only depend on the halt and the class, so only calculate them once for each.
+					const uint32 estimate_key = ((uint32)check_halt.get_id() << 9) | ((uint32)bound_for_next_transfer << 8) | next_to_load->g_class;
+					arrival_estimate_t *estimate = arrival_estimates.access(estimate_key);
+					if(estimate == NULL)
 					{
-						dbg->message("bool haltestelle_t::fetch_goods()", "Unknown arrival time for %s at %s", cnv->get_name(), get_name());
-						this_arrival_time = welt->get_ticks();
+						arrival_estimate_t new_estimate;
 
-						// Fall back to convoy's general average speed if a point-to-point average is not available.
-						// If we do not estimate speed here, we get odd results when the passengers/mail/goods decide what to board and what class to use.
-						const uint32 distance = shortest_distance(get_basis_pos(), check_halt->get_basis_pos());
-						const uint32 recorded_average_speed = cnv->get_finance_history(1, convoi_t::CONVOI_AVERAGE_SPEED);
-						const uint32 average_speed = recorded_average_speed > 0 ? recorded_average_speed : speed_to_kmh(cnv->get_min_top_speed()) / 2;
-						const uint32 journey_time_tenths_minutes = welt->travel_time_tenths_from_distance(distance, average_speed);
+						// Check to see whether this is the convoy departing from this stop that will arrive at the next transfer or ultimate destination the soonest.
+						if (bound_for_next_transfer)
+						{
+							new_estimate.best_arrival_time = calc_earliest_arrival_time_at(next_transfer, new_estimate.fast_convoy, catg_index, next_to_load->g_class);
+						}
+						else
+						{
+							// This should be called only relatively rarely, when a convoy bound for this packet's ultimate destination arrives,
+							// but this convoy is routed via an intermediate halt. Check whether it is sensible to stick to the planned route
+							// here.
+							uint32 test_time = 0;
+							halthandle_t test_transfer;
+							path_explorer_t::get_catg_path_between(catg_index, self, destination, test_time, test_transfer, next_to_load->g_class);
+							const sint64 test_time_in_ticks = welt->get_seconds_to_ticks(test_time * 6);
+							new_estimate.best_arrival_time = test_time_in_ticks + welt->get_ticks();
+						}
+
+						const arrival_times_map& check_arrivals = check_halt->get_estimated_convoy_arrival_times();
+						new_estimate.this_arrival_time = check_arrivals.get(cnv->self.get_id());
+						if (new_estimate.this_arrival_time == 0)
+						{
+							dbg->message("bool haltestelle_t::fetch_goods()", "Unknown arrival time for %s at %s", cnv->get_name(), get_name());
+							new_estimate.this_arrival_time = welt->get_ticks();
 
-						this_arrival_time += welt->get_seconds_to_ticks(journey_time_tenths_minutes * 6);
+							// Fall back to convoy's general average speed if a point-to-point average is not available.
+							// If we do not estimate speed here, we get odd results when the passengers/mail/goods decide what to board and what class to use.
+							const uint32 distance = shortest_distance(get_basis_pos(), check_halt->get_basis_pos());
+							const uint32 recorded_average_speed = cnv->get_finance_history(1, convoi_t::CONVOI_AVERAGE_SPEED);
+							const uint32 average_speed = recorded_average_speed > 0 ? recorded_average_speed : speed_to_kmh(cnv->get_min_top_speed()) / 2;
+							const uint32 journey_time_tenths_minutes = welt->travel_time_tenths_from_distance(distance, average_speed);
+
+							new_estimate.this_arrival_time += welt->get_seconds_to_ticks(journey_time_tenths_minutes * 6);
+						}
+
+						arrival_estimates.put(estimate_key, new_estimate);
+						estimate = arrival_estimates.access(estimate_key);
 					}
+					const convoihandle_t fast_convoy = estimate->fast_convoy;
+					const sint64 best_arrival_time = estimate->best_arrival_time;
+					const sint64 this_arrival_time = estimate->this_arrival_time;
 
 					bool wait_for_faster_convoy = true;
 
@@ -2511,85 +2922,99 @@ bool haltestelle_t::fetch_goods(slist_tpl<ware_t> &load, const goods_desc_t *goo
 							}
 						}
 
-						// Assume that a convoy on the same line, in the same part of its timetable will not overtake this convoy.
-
-						if(fast_convoy.is_bound() && fast_convoy->get_line() == cnv->get_line())
+						// Whether it is pointless to wait for the faster convoy does not depend on the packet.
+						bool *pointless_to_wait_for = pointless_to_wait_for_convoy.access(fast_convoy.get_id());
+						if(pointless_to_wait_for == NULL)
 						{
-							// Check for the same part of the timetable, as the convoy may either be going in a circle in a reverse direction
-							// or otherwise call at this stop at different parts of its timetable.
-							uint8 check_index = schedule->get_current_stop();
-							bool check_reverse = cnv->get_reverse_schedule();
-							schedule_t* fast_schedule = fast_convoy->get_schedule();
-							uint8 fast_index = fast_schedule->get_current_stop();
-							bool fast_reverse = fast_convoy->get_reverse_schedule();
-							const player_t* player = cnv->get_owner();
-							halthandle_t fast_convoy_halt;
-
-							for(int i = 0; i < fast_schedule->get_count() * 2; i ++)
+							bool pointless_to_wait = false;
+
+							// Assume that a convoy on the same line, in the same part of its timetable will not overtake this convoy.
+
+							if(fast_convoy.is_bound() && fast_convoy->get_line() == cnv->get_line())
 							{
-								fast_convoy_halt = haltestelle_t::get_halt(fast_schedule->entries[fast_index].pos, player);
-								if(fast_convoy_halt == self)
+								// Check for the same part of the timetable, as the convoy may either be going in a circle in a reverse direction
+								// or otherwise call at this stop at different parts of its timetable.
+								uint8 check_index = schedule->get_current_stop();
+								bool check_reverse = cnv->get_reverse_schedule();
+								schedule_t* fast_schedule = fast_convoy->get_schedule();
+								uint8 fast_index = fast_schedule->get_current_stop();
+								bool fast_reverse = fast_convoy->get_reverse_schedule();
+								const player_t* player = cnv->get_owner();
+								halthandle_t fast_convoy_halt;
+
+								for(int i = 0; i < fast_schedule->get_count() * 2; i ++)
 								{
-									if(fast_index == check_index && fast_reverse == check_reverse)
-									{
-										// The next convoy of the same line will arrive at the same position in its schedule, so
-										// do not wait for it as it is not likely actually to be faster, no matter what the estimated
-										// times may say.
-										wait_for_faster_convoy = false;
-										break;
-									}
-									else
+									fast_convoy_halt = haltestelle_t::get_halt(fast_schedule->entries[fast_index].pos, player);
+									if(fast_convoy_halt == self)
 									{
-										// The next convoy is at a different point in its schedule, so respect the estimated times.
-										break;
+										if(fast_index == check_index && fast_reverse == check_reverse)
+										{
+											// The next convoy of the same line will arrive at the same position in its schedule, so
+											// do not wait for it as it is not likely actually to be faster, no matter what the estimated
+											// times may say.
+											pointless_to_wait = true;
+											break;
+										}
+										else
+										{
+											// The next convoy is at a different point in its schedule, so respect the estimated times.
+											break;
+										}
 									}
+									fast_schedule->increment_index(&fast_index, &fast_reverse);
 								}
-								fast_schedule->increment_index(&fast_index, &fast_reverse);
 							}
-						}
 
-						// Also, if this stop has a wait for load order without a maximum time and the faster convoy
-						// also has that, do not wait for a "faster" convoy, as it may never come.
+							// Also, if this stop has a wait for load order without a maximum time and the faster convoy
+							// also has that, do not wait for a "faster" convoy, as it may never come.
 
-						const schedule_entry_t schedule_entry = cnv->get_schedule()->get_current_entry();
-						if (!fast_convoy.is_bound())
-						{
-							wait_for_faster_convoy = false;
-						}
-						else if(schedule_entry.minimum_loading > 0 && !schedule_entry.wait_for_time && schedule_entry.waiting_time_shift == 0)
-						{
-							// This convoy has an untimed wait for load order.
-							if(fast_convoy->get_line() == cnv->get_line())
+							const schedule_entry_t schedule_entry = cnv->get_schedule()->get_current_entry();
+							if (!fast_convoy.is_bound())
 							{
-								wait_for_faster_convoy = false;
+								pointless_to_wait = true;
 							}
-							else
+							else if(schedule_entry.minimum_loading > 0 && !schedule_entry.wait_for_time && schedule_entry.waiting_time_shift == 0)
 							{
-								// Check to see whether this has the same untimed wait for load order even if it is not on the same line.
-								schedule_entry_t fast_convoy_schedule_entry = fast_convoy->get_schedule()->get_current_entry();
-								if(haltestelle_t::get_halt(fast_convoy_schedule_entry.pos, cnv->get_owner()) == self)
+								// This convoy has an untimed wait for load order.
+								if(fast_convoy->get_line() == cnv->get_line())
 								{
-									if(fast_convoy_schedule_entry.minimum_loading > 0 && !fast_convoy_schedule_entry.wait_for_time && fast_convoy_schedule_entry.waiting_time_shift == 0)
-									{
-										wait_for_faster_convoy = false;
-									}
+									pointless_to_wait = true;
 								}
 								else
 								{
-									for(int i = 0; i < fast_convoy->get_schedule()->get_count(); i++)
+									// Check to see whether this has the same untimed wait for load order even if it is not on the same line.
+									schedule_entry_t fast_convoy_schedule_entry = fast_convoy->get_schedule()->get_current_entry();
+									if(haltestelle_t::get_halt(fast_convoy_schedule_entry.pos, cnv->get_owner()) == self)
+									{
+										if(fast_convoy_schedule_entry.minimum_loading > 0 && !fast_convoy_schedule_entry.wait_for_time && fast_convoy_schedule_entry.waiting_time_shift == 0)
+										{
+											pointless_to_wait = true;
+										}
+									}
+									else
 									{
-										fast_convoy_schedule_entry = fast_convoy->get_schedule()->entries[i];
-										if(haltestelle_t::get_halt(fast_convoy_schedule_entry.pos, cnv->get_owner()) == self)
+										for(int i = 0; i < fast_convoy->get_schedule()->get_count(); i++)
 										{
-											if(fast_convoy_schedule_entry.minimum_loading > 0 && !fast_convoy_schedule_entry.wait_for_time && fast_convoy_schedule_entry.waiting_time_shift == 0)
+											fast_convoy_schedule_entry = fast_convoy->get_schedule()->entries[i];
+											if(haltestelle_t::get_halt(fast_convoy_schedule_entry.pos, cnv->get_owner()) == self)
 											{
-												wait_for_faster_convoy = false;
-												break;
+												if(fast_convoy_schedule_entry.minimum_loading > 0 && !fast_convoy_schedule_entry.wait_for_time && fast_convoy_schedule_entry.waiting_time_shift == 0)
+												{
+													pointless_to_wait = true;
+													break;
+												}
 											}
 										}
 									}
 								}
 							}
+
+							pointless_to_wait_for_convoy.put(fast_convoy.get_id(), pointless_to_wait);
+							pointless_to_wait_for = pointless_to_wait_for_convoy.access(fast_convoy.get_id());
+						}
+						if(*pointless_to_wait_for)
+						{
+							wait_for_faster_convoy = false;
 						}
 
 						if(wait_for_faster_convoy)
@@ -2942,6 +3367,7 @@ bool haltestelle_t::vereinige_waren(const ware_t &ware) //"unite were" (Google)
 				{
 					// update route if there is newer route
 					tmp.set_zwischenziel( ware.get_zwischenziel() );
+					invalidate_cargo_index(ware.get_desc()->get_catg_index());
 				}
 
 				// Merge waiting times.
@@ -2975,26 +3401,33 @@ void haltestelle_t::add_ware_to_halt(ware_t ware, bool from_saved)
 	ware.set_last_transfer(self);
 
 	// now we have to add the ware to the stop
-	vector_tpl<ware_t> * warray = cargo[ware.get_desc()->get_catg_index()];
+	const uint8 catg = ware.get_desc()->get_catg_index();
+	vector_tpl<ware_t> * warray = cargo[catg];
 	if(warray==NULL)
 	{
 		// this type was not stored here before ...
 		warray = new vector_tpl<ware_t>(4);
-		cargo[ware.get_desc()->get_catg_index()] = warray;
+		cargo[catg] = warray;
 	}
 	resort_freight_info = true;
 	if(!from_saved)
 	{
 		// the ware will be put into the first entry with menge==0
-		FOR(vector_tpl<ware_t>, & i, *warray) {
-			if (i.menge == 0) {
-				i = ware;
+		for(uint32 i = 0; i < warray->get_count(); i++) {
+			if ((*warray)[i].menge == 0) {
+				(*warray)[i] = ware;
+				if(cargo_index[catg]) {
+					add_to_cargo_index(cargo_index[catg], catg, i);
+				}
 				return;
 			}
 		}
 		// here, if no free entries found
 	}
 	warray->append(ware);
+	if(cargo_index[catg]) {
+		add_to_cargo_index(cargo_index[catg], catg, warray->get_count() - 1);
+	}
 }
 
 void haltestelle_t::add_to_waiting_list(ware_t ware, sint64 ready_time)
@@ -3653,6 +4086,7 @@ void haltestelle_t::transfer_goods(halthandle_t halt)
 			}
 			delete cargo[i];
 			cargo[i] = NULL;
+			invalidate_cargo_index(i);
 		}
 	}
 }
@@ -195,6 +195,42 @@ private:
 	 */
 	vector_tpl<uint8> categories_to_refresh_next_step;
 
+	// All halts with categories_to_refresh_next_step, in the order they were requested
+	static vector_tpl<halthandle_t> halts_to_reroute;
+
+	/* Effects of re-routing on other halts and factories:
+	 * passengers walking on to their next transfer and
+	 * goods without any connection left. These are held
+	 * back while the halts are re-routed in parallel.
+	 */
+	vector_tpl<ware_t> rerouted_walking;
+	vector_tpl<ware_t> rerouted_discarded;
+
+	// Re-routes the goods of a category, but only collects the effects on others (thread safe)
+	uint32 reroute_goods_intern(uint8 catg);
+
+	// Applies the collected effects of reroute_goods_intern()
+	void finish_reroute_goods();
+
+	/**
+	 * Re-routes the goods of the first halts in halts_to_reroute, multi-threaded
+	 * if possible. The effects on other halts are applied afterwards in
+	 * the order of the list, so the outcome does not depend on the threads.
+	 */
+	static void reroute_goods_all();
+#ifdef MULTI_THREAD
+	static void *reroute_goods_threaded(void *args);
+#endif
+
+public:
+	/**
+	 * Loads/saves halts_to_reroute, since the halts still waiting
+	 * for their turn are re-routed in later steps.
+	 */
+	static void rdwr_reroute_queue(loadsave_t *file);
+
+private:
+
 	/**
 	* This is the list of passengers/mail/goods that
 	* have arrived at this stop but are in the process
@@ -394,6 +430,36 @@ private:
 	// Array with different categories that contains all waiting goods at this stop
 	vector_tpl<ware_t> **cargo;
 
+	/**
+	 * Index of the waiting goods of one category: the positions in cargo,
+	 * grouped by (halt, class). Each packet is listed under its next transfer
+	 * and under its destination; halt id 0 lists all packets of a class.
+	 * Entries may be stale (emptied, reused or removed slots), so every hit
+	 * must be checked against the bounds and the packet itself.
+	 */
+	struct cargo_index_t
+	{
+		inthashtable_tpl<uint32, vector_tpl<uint32>, N_BAGS_MEDIUM> groups;
+		uint32 entries;
+		cargo_index_t() : entries(0) {}
+	};
+
+	// One index per category, NULL until needed by fetch_goods()
+	cargo_index_t **cargo_index;
+
+	static uint32 get_cargo_index_key(halthandle_t halt, uint8 g_class) { return ((uint32)halt.get_id() << 8) | g_class; }
+
+	void add_to_cargo_index(cargo_index_t *index, uint8 catg, uint32 pos);
+
+	// returns the (re)built index of this category
+	cargo_index_t *get_cargo_index(uint8 catg);
+
+	// must be called whenever the positions in cargo[catg] change
+	void invalidate_cargo_index(uint8 catg);
+
+	// removes the emptied packet at pos, the last packet takes its place (also in the index)
+	void remove_empty_ware(uint8 catg, uint32 pos);
+
 	/**
 	 * Liste der angeschlossenen Fabriken
 	 */
@@ -973,7 +1039,7 @@ public:
 	*/
 	inline uint32 get_transshipment_time() const { return transshipment_time; }
 
-	void set_reroute_goods_next_step(uint8 catg) { categories_to_refresh_next_step.append(catg); }
+	void set_reroute_goods_next_step(uint8 catg);
 
 	/**
 	* Calculate the transfer and transshipment time values.
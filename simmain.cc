@@ -62,6 +62,7 @@
 #include "dataobj/settings.h"
 #include "dataobj/translator.h"
 #include "network/pakset_info.h"
+#include "network/command_log.h"
 
 #include "descriptor/reader/obj_reader.h"
 #include "descriptor/sound_desc.h"
@@ -74,6 +75,7 @@
 #include "utils/simrandom.h"
 
 #include "bauer/vehikelbauer.h"
+#include "bauer/wegbauer.h"
 
 #include "vehicle/simvehicle.h"
 #include "vehicle/simroadtraffic.h"
@@ -187,12 +189,42 @@ static void show_times(karte_t *welt, main_view_t *view)
 	}
 	dbg->message( "grund_t::get_neighbour()", "%i iterations took %li ms", i*weg_t::get_alle_wege().get_count(), dr_time() - ms );
 
+	// way search as for dragging ways: the same routes on the map for each waytype
+	const koord size = welt->get_size();
+	const koord way_routes[][2] = {
+		{ koord(size.x/2-16, size.y/2), koord(size.x/2+16, size.y/2+8) },
+		{ koord(size.x/8, size.y/2), koord(size.x*7/8, size.y/2) },
+		{ koord(size.x/8, size.y/8), koord(size.x*7/8, size.y*7/8) }
+	};
+	const way_builder_t::bautyp_t way_types[] = { way_builder_t::strasse, way_builder_t::schiene, way_builder_t::leitung };
+	for(  uint w = 0;  w < lengthof(way_types);  w++  ) {
+		const way_desc_t *desc = way_types[w] == way_builder_t::leitung ? way_builder_t::leitung_desc : way_builder_t::weg_search( (waytype_t)way_types[w], 100, welt->get_timeline_year_month(), type_flat );
+		if(  desc == NULL  ) {
+			continue;
+		}
+		for(  uint r = 0;  r < lengthof(way_routes);  r++  ) {
+			const grund_t *from = welt->lookup_kartenboden(way_routes[r][0]);
+			const grund_t *to = welt->lookup_kartenboden(way_routes[r][1]);
+			if(  from == NULL  ||  to == NULL  ) {
+				continue;
+			}
+			way_builder_t bauigel(welt->get_active_player());
+			bauigel.init_builder( way_types[w], desc );
+			ms = dr_time();
+			for (i = 0; i < 10; i++) {
+				bauigel.calc_route( from->get_pos(), to->get_pos() );
+			}
+			dbg->message( "way_builder_t::calc_route()", "%s from %i,%i to %i,%i: %i iterations took %li ms, route of %u tiles", desc->get_name(), way_routes[r][0].x, way_routes[r][0].y, way_routes[r][1].x, way_routes[r][1].y, i, dr_time() - ms, bauigel.get_count() );
+		}
+	}
+
 	ms = dr_time();
 	for (i = 0; i < 2000; i++) {
 		welt->sync_step(200,true,true);
 		welt->step();
 	}
 	dbg->message( "welt->sync_step/step(200,1,1)", "%i iterations took %li ms", i, dr_time() - ms );
+	dbg->message( "karte_t::step()", "%u convoys stepped, %u skipped while waiting in the last step", welt->get_convoys_stepped(), welt->get_convoys_skipped() );
 }
 #endif
 
@@ -452,6 +484,9 @@ void print_help()
 		" -objects DIR_NAME/  load the pakset in specified directory\n"
 		" -pause              starts game with paused after loading\n"
 		"                     a server will pause if there are no clients, even if this be not specified in simuconf.tab\n"
+		" -record NAME        server records its commands to NAME.rec (see server_command_log)\n"
+		" -replay NAME        replays the recording NAME.rec as fast as possible and quits,\n"
+		"                     the exit code is not zero if the checklists differ\n"
 		" -res N              starts in specified resolution: \n"
 		"                      1=640x480, 2=800x600, 3=1024x768, 4=1280x1024\n"
 		" -screensize WxH     set screensize to width W and height H\n"
@@ -473,7 +508,7 @@ void print_help()
 #endif
 		" -timeline           enables timeline\n"
 #if defined DEBUG || defined PROFILE
-		" -times              does some simple profiling\n"
+		" -times              does some simple profiling (drawing, way search, steps)\n"
 		" -until YEAR.MONTH   quits when MONTH of YEAR starts\n"
 #endif
 		" -use_workdir        Use current directory as data directory. If this parameter is\n"
@@ -1295,6 +1330,16 @@ int simu_main(int argc, char** argv)
 		new_world = false;
 	}
 
+	// replay a recording of a server (the world is loaded in karte_t::interactive)
+	bool replay = false;
+	if(  const char *name = gimme_arg(argc, argv, "-replay", 1)  ) {
+		dr_chdir( env_t::user_dir );
+		if(  !command_log_t::init_replay(name)  ) {
+			dbg->fatal("simu_main()", "Cannot replay \"%s\"", name );
+		}
+		replay = true;
+	}
+
 	// recover last server game
 	if(  new_world  &&  env_t::server  ) {
 		dr_chdir( env_t::user_dir );
@@ -1447,6 +1492,10 @@ int simu_main(int argc, char** argv)
 		env_t::server_admin_pw = ref_str;
 	}
 
+	if(  const char *ref_str = gimme_arg(argc, argv, "-record", 1)  ) {
+		env_t::server_command_log = ref_str;
+	}
+
 	if(  env_t::server_dns.empty()  &&  !env_t::server_alt_dns.empty()  ) {
 		dbg->warning( "simu_main()", "server_altdns but not server_dns set. Please use server_dns first!" );
 		env_t::server_dns = env_t::server_alt_dns;
@@ -1505,6 +1554,11 @@ int simu_main(int argc, char** argv)
 	welt->set_fast_forward(false);
 	baum_t::recalc_outline_color();
 
+	if(  replay  ) {
+		// no banner or new world dialogue
+		new_world = false;
+	}
+
 	uint32 quit_month = 0x7FFFFFFFu;
 
 #if defined DEBUG || defined PROFILE
@@ -1653,5 +1707,5 @@ int simu_main(int argc, char** argv)
 	freelist_t::free_all_nodes();
 #endif
 
-	return EXIT_SUCCESS;
+	return command_log_t::replay_failed() ? EXIT_FAILURE : EXIT_SUCCESS;
 }
@@ -1916,7 +1916,7 @@ const char *tool_add_city_t::work( player_t *player, koord3d pos )
 				stadt->finish_rd();
 
 				player_t::book_construction_costs(player, welt->get_settings().cst_found_city, k, ignore_wt);
-				minimap_t::get_instance()->calc_map();
+				minimap_t::get_instance()->invalidate_map_area( stadt->get_linksoben(), stadt->get_rechtsunten() );
 				return NULL;
 			}
 		}
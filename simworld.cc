@@ -56,6 +56,7 @@
 #include "vehicle/simvehicle.h"
 #include "vehicle/simroadtraffic.h"
 #include "vehicle/movingobj.h"
+#include "vehicle/private_car_flow.h"
 #include "boden/wege/schiene.h"
 
 #include "obj/zeiger.h"
@@ -80,6 +81,8 @@
 #include "network/network_file_transfer.h"
 #include "network/network_socket_list.h"
 #include "network/network_cmd_ingame.h"
+#include "network/state_hash.h"
+#include "network/command_log.h"
 #include "dataobj/height_map_loader.h"
 #include "dataobj/ribi.h"
 #include "dataobj/translator.h"
@@ -118,6 +121,8 @@
 #include "player/ai_passenger.h"
 #include "player/ai_goods.h"
 
+#include "script/script.h"
+
 #include "dataobj/tabfile.h" // For reload of simuconf.tab to override savegames
 
 #ifdef MULTI_THREAD
@@ -1905,13 +1910,7 @@ void *step_convoys_threaded(void* args)
 			return NULL;
 		}
 
-		// since convois will be deleted during stepping, we need to step backwards
-		for (uint32 i = world->convoi_array.get_count(); i-- != 0;)
-		{
-			convoihandle_t cnv = world->convoi_array[i];
-			convoys_next_step.append(cnv);
-		}
-
+		// convoys_next_step was filled by start_convoy_threads()
 		simthread_barrier_wait(&step_convoys_barrier_internal);
 		simthread_barrier_wait(&step_convoys_barrier_internal); // The multiples of these is intentional: we must wait for the individual threads to finish before the clear() command is executed.
 		convoys_next_step.clear();
@@ -1956,6 +1955,18 @@ void* step_individual_convoy_threaded(void* args)
 
 void karte_t::start_convoy_threads()
 {
+	// Only convoys searching for a route have anything to do in threaded_step(),
+	// and ROUTING_2 is only ever set in the single threaded step().
+	// The list is made here, as convoys may be deleted on this thread while the threads run.
+	// Since convois will be deleted during stepping, we need to step backwards.
+	for (uint32 i = convoi_array.get_count(); i-- != 0;)
+	{
+		convoihandle_t cnv = convoi_array[i];
+		if (cnv->get_state() == convoi_t::ROUTING_2)
+		{
+			::convoys_next_step.append(cnv);
+		}
+	}
 	simthread_barrier_wait(&step_convoys_barrier_external);
 	convoy_threads_working = true;
 }
@@ -2137,6 +2148,7 @@ void karte_t::init_threads()
 	const sint32 parallel_operations = get_parallel_operations();
 
 	private_cars_added_threaded = new vector_tpl<private_car_t*>[parallel_operations + 2];
+	private_car_flow_t::init_threads(parallel_operations + 2);
 	pedestrians_added_threaded = new vector_tpl<pedestrian_t*>[parallel_operations + 2];
 	transferring_cargoes = new vector_tpl<transferring_cargo_t>[parallel_operations + 2];
 	marker_t::markers = new marker_t[parallel_operations * 2];
@@ -2330,6 +2342,7 @@ void karte_t::destroy_threads()
 
 	delete[] private_cars_added_threaded;
 	private_cars_added_threaded = NULL;
+	private_car_flow_t::exit_threads();
 	delete[] pedestrians_added_threaded;
 	pedestrians_added_threaded = NULL;
 	delete[] transferring_cargoes;
@@ -3112,7 +3125,10 @@ karte_t::karte_t() :
 	network_frame_count = 0;
 	sync_steps = 0;
 	sync_steps_barrier = sync_steps;
+	first_checklist_sync_step = 0;
 	next_step_passenger = 0;
+	convoys_stepped = 0;
+	convoys_skipped = 0;
 	next_step_mail = 0;
 	destroying = false;
 	transferring_cargoes = NULL;
@@ -5178,6 +5194,7 @@ void karte_t::new_month()
 	FOR(vector_tpl<weg_t*>, const w, weg_t::get_alle_wege()) {
 		w->new_month();
 	}
+	private_car_flow_t::new_month();
 
 	// Update the maximum vehicle speed records to calibrate when passengers should not burden the journey time database.
 	calc_max_vehicle_speeds();
@@ -5330,6 +5347,7 @@ void karte_t::new_month()
 	}
 
 	scenario->new_month();
+	script_vm_t::dump_all_profiles();
 
 	// now switch year to get the right year for all timeline stuff ...
 	if( last_month == 0 ) {
@@ -5804,7 +5822,10 @@ void karte_t::step()
 	for (uint32 i = convoi_array.get_count(); i-- != 0;)
 	{
 		convoihandle_t cnv = convoi_array[i];
-		cnv->threaded_step();
+		if (cnv->get_state() == convoi_t::ROUTING_2)
+		{
+			cnv->threaded_step();
+		}
 	}
 #endif
 
@@ -5813,9 +5834,18 @@ void karte_t::step()
 	// The more computationally intensive parts of this have been extracted and made multi-threaded.
 	DBG_DEBUG4("karte_t::step 4", "step %d convois", convoi_array.get_count());
 	// since convois will be deleted during stepping, we need to step backwards
+	convoys_stepped = 0;
+	convoys_skipped = 0;
 	for (uint32 i = convoi_array.get_count(); i-- != 0;) {
 		convoihandle_t cnv = convoi_array[i];
-		cnv->step();
+		// convoys still waiting (counted down in sync_step()) would return from step() at once
+		if(cnv->get_wait_lock() != 0) {
+			convoys_skipped++;
+		}
+		else {
+			cnv->step();
+			convoys_stepped++;
+		}
 		if((i&7)==0) {
 			INT_CHECK("karte_t::step 3");
 		}
@@ -6015,6 +6045,7 @@ void karte_t::step()
 	}
 #endif
 #endif
+	private_car_flow_t::step();
 	INT_CHECK("karte_t::step 5");
 
 	DBG_DEBUG4("karte_t::step", "step factories");
@@ -8948,6 +8979,11 @@ DBG_MESSAGE("karte_t::save(loadsave_t *file)", "motd filename %s", env_t::server
 		file->rdwr_long(cities_to_process);
 	}
 
+	if (file->get_extended_version() >= 15 || (file->get_extended_version() == 14 && file->get_extended_revision() >= 43))
+	{
+		haltestelle_t::rdwr_reroute_queue(file);
+	}
+
 	// MUST be at the end of the load/save routine.
 	// save all open windows (upon request)
 	file->rdwr_byte( active_player_nr );
@@ -9095,9 +9131,10 @@ bool karte_t::load(const char *filename)
 		// probably finish network mode first?
 		if(  env_t::networkmode  ) {
 			if(  env_t::server  ) {
+				// the game for joining clients, see nwc_sync_t::get_join_filename()
 				char fn[256];
-				sprintf( fn, "server%d-network.sve", env_t::server );
-				if(  strcmp(filename, fn) != 0  ) {
+				sprintf( fn, "server%d-network", env_t::server );
+				if(  !strstart(filename, fn)  ) {
 					// stay in networkmode, but disconnect clients
 					dbg->warning("karte_t::load","disconnecting all clients");
 					network_reset_server();
@@ -9342,6 +9379,8 @@ void karte_t::clear_checklist_history()
 	for(  int i=0;  i<LAST_CHECKLISTS_COUNT;  ++i  ) {
 		last_checklists[i] = checklist_t();
 	}
+	first_checklist_sync_step = 0;
+	state_hash_t::reset();
 }
 
 void karte_t::clear_checklist_rands()
@@ -10228,6 +10267,11 @@ DBG_MESSAGE("karte_t::load()", "%d factories loaded", fab_list.get_count());
 		file->rdwr_long(cities_to_process);
 	}
 
+	if (file->get_extended_version() >= 15 || (file->get_extended_version() == 14 && file->get_extended_revision() >= 43))
+	{
+		haltestelle_t::rdwr_reroute_queue(file);
+	}
+
 	// MUST be at the end of the load/save routine.
 	if(  file->is_version_atleast(102, 4)  ) {
 		if(  env_t::restore_UI  ) {
@@ -10939,6 +10983,8 @@ void karte_t::network_game_set_pause(bool pause_, uint32 syncsteps_)
 		time_multiplier = 16;// reset to normal speed
 		sync_steps = syncsteps_;
 		sync_steps_barrier = sync_steps;
+		// older checklists are from before loading, hence commands referring to them cannot be checked
+		first_checklist_sync_step = sync_steps;
 		steps = sync_steps / settings.get_frames_per_step();
 		network_frame_count = sync_steps % settings.get_frames_per_step();
 		dbg->warning("karte_t::network_game_set_pause", "steps=%d sync_steps=%d pause=%d", steps, sync_steps, pause_);
@@ -11010,6 +11056,12 @@ void karte_t::command_queue_append(network_world_command_t* nwc) const
 }
 
 
+const slist_tpl<network_world_command_t*>& karte_t::get_command_queue() const
+{
+	return command_queue;
+}
+
+
 void karte_t::clear_command_queue() const
 {
 	while (!command_queue.empty()) {
@@ -11143,8 +11195,6 @@ void karte_t::process_network_commands(sint32 *ms_difference)
 		// fetch the next command
 		nwc = network_get_received_command();
 	}
-	uint32 next_command_step = get_next_command_step();
-
 	// Knightly : check if changed limits, if any, have to be transmitted to all clients
 	if (env_t::server)
 	{
@@ -11156,6 +11206,12 @@ void karte_t::process_network_commands(sint32 *ms_difference)
 	network_process_send_queues( next_step_time>ms ? min( next_step_time-ms, 5) : 0 );
 
 	// process enqueued network world commands
+	process_command_queue();
+}
+
+void karte_t::process_command_queue()
+{
+	uint32 next_command_step = get_next_command_step();
 	while(  !command_queue.empty()  &&  (next_command_step<=sync_steps/*  ||  step_mode&PAUSE_FLAG*/)  ) {
 		network_world_command_t *nwc = command_queue.remove_first();
 		if (nwc) {
@@ -11280,6 +11336,7 @@ bool karte_t::interactive(uint32 quit_month)
 	if(  env_t::networkmode  ) {
 		clear_checklist_history();
 	}
+	command_log_t::start_replay(this);
 	sint32 ms_difference = 0;
 	reset_timer();
 	DBG_DEBUG4("karte_t::interactive", "welcome in this routine");
@@ -11327,7 +11384,13 @@ bool karte_t::interactive(uint32 quit_month)
 			break;
 		}
 
-		if(  env_t::networkmode  ) {
+		if(  command_log_t::is_replaying()  ) {
+			command_log_t::replay(this);
+			// as fast as possible, without waiting for a server
+			sync_steps_barrier = sync_steps + 1;
+			next_step_time = dr_time();
+		}
+		else if(  env_t::networkmode  ) {
 			process_network_commands(&ms_difference);
 
 		}
@@ -11404,6 +11467,10 @@ bool karte_t::interactive(uint32 quit_month)
 					LCHKLST(sync_steps) = checklist_t(sync_steps, (uint32)steps, network_frame_count, get_random_seed(), halthandle_t::get_next_check(), linehandle_t::get_next_check(), convoihandle_t::get_next_check(),
 						rands, debug_sums
 					);
+					if(  env_t::networkmode  ) {
+						state_hash_t::step(this);
+						command_log_t::step(this);
+					}
 
 #ifdef DEBUG_SIMRAND_CALLS
 					char buf[2048];
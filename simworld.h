@@ -413,6 +413,12 @@ private:
 	 */
 	vector_tpl<convoihandle_t> convoi_array;
 
+	/**
+	 * Number of convoys stepped and skipped because they were still waiting in the last step.
+	 */
+	uint32 convoys_stepped;
+	uint32 convoys_skipped;
+
 	/**
 	 * Array containing the factories.
 	 */
@@ -624,6 +630,8 @@ private:
 	/// @note variable used in interactive()
 	checklist_t last_checklists[LAST_CHECKLISTS_COUNT];
 #define LCHKLST(x) (last_checklists[(x) % LAST_CHECKLISTS_COUNT])
+	/// checklists before this sync step were not computed from the current game state (set when joining)
+	uint32 first_checklist_sync_step;
 	uint32 rands[CHK_RANDS];
 	uint32 debug_sums[CHK_DEBUG_SUMS];
 
@@ -2309,6 +2317,8 @@ public:
 	void add_convoi(convoihandle_t const &cnv);
 	void rem_convoi(convoihandle_t const &cnv);
 	vector_tpl<convoihandle_t> const& convoys() const { return convoi_array; }
+	uint32 get_convoys_stepped() const { return convoys_stepped; }
+	uint32 get_convoys_skipped() const { return convoys_skipped; }
 
 	/**
 	 * To access the cities array.
@@ -2594,7 +2604,7 @@ public:
 	/**
 	 * Checks whether checklist is available, ie given sync_step is not too far into past.
 	 */
-	bool is_checklist_available(const uint32 sync_step) const { return sync_step + LAST_CHECKLISTS_COUNT > sync_steps; }
+	bool is_checklist_available(const uint32 sync_step) const { return sync_step >= first_checklist_sync_step  &&  sync_step + LAST_CHECKLISTS_COUNT > sync_steps; }
 	const checklist_t& get_checklist_at(const uint32 sync_step) const { return LCHKLST(sync_step); }
 	void set_checklist_at(const uint32 sync_step, const checklist_t &chklst) { LCHKLST(sync_step) = chklst; }
 
@@ -2610,6 +2620,12 @@ public:
 
 	void clear_command_queue() const;
 
+	/// world commands waiting for execution, sorted by sync step
+	const slist_tpl<network_world_command_t*>& get_command_queue() const;
+
+	/// executes the queued world commands that are due
+	void process_command_queue();
+
 	void network_disconnect();
 
 	sint32 get_citycar_speed_average() const { return citycar_speed_average; }
@@ -2,7 +2,12 @@
 
 #include "squirrel/sqpcheader.h" // for declarations...
 #include "squirrel/sqvm.h"       // for Raise_Error_vl
+#include "squirrel/sqstring.h"
+#include "squirrel/sqfuncproto.h"
+#include "squirrel/sqclosure.h"
 #include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
 
 
 void* get_instanceup(HSQUIRRELVM vm, SQInteger index, void* tag, const char* type)
@@ -39,6 +44,99 @@ SQRESULT sq_call_restricted(HSQUIRRELVM v, SQInteger params, SQBool retval, SQBo
 	return ret;
 }
 
+void sq_setprofiling(HSQUIRRELVM v, SQBool enable)
+{
+	SQSharedState *ss = _ss(v);
+	if (enable  &&  ss->_profiler == NULL) {
+		if (ss->_profile == NULL) {
+			ss->_profile = new SQProfile();
+			ss->_profile->entries = NULL;
+			ss->_profile->count = 0;
+			ss->_profile->size = 0;
+		}
+		ss->_profiler = ss->_profile;
+	}
+	else if (!enable) {
+		ss->_profiler = NULL;
+	}
+}
+
+
+const SQProfile* sq_getprofile(HSQUIRRELVM v)
+{
+	return _ss(v)->_profile;
+}
+
+
+void sq_deleteprofile(SQProfile *p)
+{
+	for(SQInteger i=0; i<p->count; i++) {
+		delete [] p->entries[i].name;
+	}
+	delete [] p->entries;
+	delete p;
+}
+
+
+/// @returns index of a new entry named @p name (@p source:@p line)
+static SQInteger sq_profile_new_entry(SQProfile *p, const SQObjectPtr &name, const SQObjectPtr &source, SQInteger line, bool native)
+{
+	if (p->count == p->size) {
+		p->size = p->size ? 2*p->size : 64;
+		SQProfile::entry_t *entries = new SQProfile::entry_t[p->size];
+		if (p->count) {
+			memcpy(entries, p->entries, p->count * sizeof(SQProfile::entry_t));
+		}
+		delete [] p->entries;
+		p->entries = entries;
+	}
+	char buf[256];
+	const SQChar *n = type(name) == OT_STRING ? _stringval(name) : "unknown";
+	if (type(source) == OT_STRING) {
+		snprintf(buf, sizeof(buf), "%s (%s:%d)", n, _stringval(source), (int)line);
+	}
+	else {
+		snprintf(buf, sizeof(buf), "%s", n);
+	}
+	SQProfile::entry_t &e = p->entries[p->count];
+	e.name = strcpy(new SQChar[strlen(buf) + 1], buf);
+	e.native = native;
+	e.calls = 0;
+	e.ops = 0;
+	return p->count++;
+}
+
+
+static inline SQProfile::entry_t& sq_profile_entry(SQProfile *p, SQFunctionProto *f)
+{
+	if (f->_profile_index < 0) {
+		f->_profile_index = sq_profile_new_entry(p, f->_name, f->_sourcename, f->_nlineinfos > 0 ? f->_lineinfos[0]._line : 0, false);
+	}
+	return p->entries[f->_profile_index];
+}
+
+
+void sq_profile_opcode(SQProfile *p, SQFunctionProto *f)
+{
+	sq_profile_entry(p, f).ops++;
+}
+
+
+void sq_profile_call(SQProfile *p, SQFunctionProto *f)
+{
+	sq_profile_entry(p, f).calls++;
+}
+
+
+void sq_profile_native_call(SQProfile *p, SQNativeClosure *c)
+{
+	if (c->_profile_index < 0) {
+		c->_profile_index = sq_profile_new_entry(p, c->_name, SQObjectPtr(), 0, true);
+	}
+	p->entries[c->_profile_index].calls++;
+}
+
+
 SQRESULT sq_resumevm(HSQUIRRELVM v, SQBool retval, SQInteger ops)
 {
 	if(v->_ops_remaining < 4*ops) {
@@ -36,4 +36,47 @@ SQRESULT sq_call_restricted(HSQUIRRELVM v, SQInteger params, SQBool retval, SQBo
  */
 SQRESULT sq_resumevm(HSQUIRRELVM v, SQBool retval, SQInteger ops = 1000);
 
+struct SQFunctionProto;
+struct SQNativeClosure;
+
+/**
+ * Profile of a virtual machine and all its threads:
+ * counts the executed opcodes and calls of each scripted function
+ * and the calls of each native function while profiling is enabled.
+ */
+struct SQProfile
+{
+	struct entry_t {
+		const SQChar *name;   ///< copy of function name and source position
+		bool native;
+		SQUnsignedInteger calls;
+		SQUnsignedInteger ops;
+	};
+	entry_t *entries;
+	SQInteger count;
+	SQInteger size;
+};
+
+/**
+ * Enables or disables profiling, the collected data is kept while disabled.
+ */
+void sq_setprofiling(HSQUIRRELVM v, SQBool enable);
+
+/**
+ * @returns the profile collected so far or NULL if profiling was never enabled
+ */
+const SQProfile* sq_getprofile(HSQUIRRELVM v);
+
+/**
+ * Frees the profile, called when the virtual machine is closed.
+ */
+void sq_deleteprofile(SQProfile *p);
+
+/// @{
+/// @name Called by the virtual machine while profiling
+void sq_profile_opcode(SQProfile *p, SQFunctionProto *f);
+void sq_profile_call(SQProfile *p, SQFunctionProto *f);
+void sq_profile_native_call(SQProfile *p, SQNativeClosure *c);
+/// @}
+
 #endif
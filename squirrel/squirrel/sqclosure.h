@@ -147,7 +147,7 @@ public:
 struct SQNativeClosure : public CHAINABLE_OBJ
 {
 private:
-	SQNativeClosure(SQSharedState *ss,SQFUNCTION func){_function=func;INIT_CHAIN();ADD_TO_CHAIN(&_ss(this)->_gc_chain,this); _env = NULL;}
+	SQNativeClosure(SQSharedState *ss,SQFUNCTION func){_function=func;INIT_CHAIN();ADD_TO_CHAIN(&_ss(this)->_gc_chain,this); _env = NULL; _profile_index = -1;}
 public:
 	static SQNativeClosure *Create(SQSharedState *ss,SQFUNCTION func,SQInteger nouters)
 	{
@@ -194,6 +194,7 @@ public:
 	SQWeakRef *_env;
 	SQFUNCTION _function;
 	SQObjectPtr _name;
+	SQInteger _profile_index; ///< index into SQProfile::entries, -1 if not yet profiled
 };
 
 
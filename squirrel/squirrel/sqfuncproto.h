@@ -124,6 +124,7 @@ public:
 	SQObjectPtr _name;
 	SQInteger _stacksize;
 	bool _bgenerator;
+	SQInteger _profile_index; ///< index into SQProfile::entries, -1 if not yet profiled
 	SQInteger _varparams;
 
 	SQInteger _nlocalvarinfos;
@@ -397,6 +397,7 @@ SQFunctionProto::SQFunctionProto(SQSharedState *ss)
 {
 	_stacksize=0;
 	_bgenerator=false;
+	_profile_index=-1;
 	INIT_CHAIN();ADD_TO_CHAIN(&_ss(this)->_gc_chain,this);
 }
 
@@ -11,6 +11,7 @@
 #include "sqarray.h"
 #include "squserdata.h"
 #include "sqclass.h"
+#include "../sq_extensions.h"
 
 //SQObjectPtr _null_;
 //SQObjectPtr _true_(true);
@@ -27,6 +28,8 @@ SQSharedState::SQSharedState()
 	_notifyallexceptions = false;
 	_foreignptr = NULL;
 	_releasehook = NULL;
+	_profile = NULL;
+	_profiler = NULL;
 }
 
 #define newsysstring(s) {   \
@@ -166,6 +169,7 @@ void SQSharedState::Init()
 SQSharedState::~SQSharedState()
 {
 	if(_releasehook) { _releasehook(_foreignptr,0); _releasehook = NULL; }
+	if(_profile) { sq_deleteprofile(_profile); _profile = _profiler = NULL; }
 	_constructoridx.Null();
 	_table(_registry)->Finalize();
 	_table(_consts)->Finalize();
@@ -111,6 +111,8 @@ public:
 	bool _notifyallexceptions;
 	SQUserPointer _foreignptr;
 	SQRELEASEHOOK _releasehook;
+	struct SQProfile *_profile;   ///< collected profile, if profiling was ever enabled
+	struct SQProfile *_profiler;  ///< equals _profile while profiling is enabled, NULL otherwise
 private:
 	SQChar *_scratchpad;
 	SQInteger _scratchpadsize;
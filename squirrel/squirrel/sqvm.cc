@@ -13,6 +13,7 @@
 #include "squserdata.h"
 #include "sqarray.h"
 #include "sqclass.h"
+#include "../sq_extensions.h"
 
 #define TOP() (_stack._vals[_top-1])
 
@@ -374,6 +375,9 @@ bool SQVM::Init(SQVM *friendvm, SQInteger stacksize)
 bool SQVM::StartCall(SQClosure *closure,SQInteger target,SQInteger args,SQInteger stackbase,bool tailcall)
 {
 	SQFunctionProto *func = closure->_function;
+	if (_ss(this)->_profiler) {
+		sq_profile_call(_ss(this)->_profiler, func);
+	}
 
 	SQInteger paramssize = func->_nparameters;
 	const SQInteger newtop = stackbase + func->_stacksize;
@@ -730,6 +734,10 @@ exception_restore:
 				}
 			}
 
+			if (_ss(this)->_profiler) {
+				sq_profile_opcode(_ss(this)->_profiler, _closure(ci->_closure)->_function);
+			}
+
 			const SQInstruction &_i_ = *ci->_ip++;
 			//dumpstack(_stackbase);
 			//scprintf("\n[%d] %s %d %d %d %d\n",ci->_ip-ci->_iv->_vals,g_InstrDesc[_i_.op].name,arg0,arg1,arg2,arg3);
@@ -1194,6 +1202,9 @@ bool SQVM::CallNative(SQNativeClosure *nclosure, SQInteger nargs, SQInteger newb
 
 	if(!EnterFrame(newbase, newtop, false)) return false;
 	ci->_closure  = nclosure;
+	if (_ss(this)->_profiler) {
+		sq_profile_native_call(_ss(this)->_profiler, nclosure);
+	}
 
 	SQInteger outers = nclosure->_noutervalues;
 	for (SQInteger i = 0; i < outers; i++) {
@@ -0,0 +1,137 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef TPL_KOORDMAP_TPL_H
+#define TPL_KOORDMAP_TPL_H
+
+
+#include "vector_tpl.h"
+#include "koordhashtable_tpl.h"
+
+
+/*
+ * Map from 2d koord like keys (koord, id_pair, departure_point_t) to values,
+ * with the same interface as koordhashtable_tpl.
+ * The entries are kept in a single array sorted by key, so a map with only a few
+ * entries (like the journey times of a schedule) needs one allocation instead of
+ * one list node per entry, and lookups are a binary search in contiguous memory.
+ */
+template<class key_t, class value_t>
+class koordmap_tpl
+{
+public:
+	struct node_t {
+	public:
+		key_t   key;
+		value_t value;
+
+		int operator == (const node_t &x) const { return key == x.key; }
+	};
+
+	typedef typename vector_tpl<node_t>::const_iterator const_iterator;
+	typedef typename vector_tpl<node_t>::iterator       iterator;
+
+private:
+	typedef koordhash_tpl<key_t> hash_t;
+
+	vector_tpl<node_t> nodes;
+
+	/// @return index of the first entry with a key not less than @p key
+	uint32 lower_bound(const key_t key) const
+	{
+		uint32 low = 0, high = nodes.get_count();
+		while(  low < high  ) {
+			const uint32 mid = (low + high) >> 1;
+			if(  hash_t::comp(nodes[mid].key, key) < 0  ) {
+				low = mid + 1;
+			}
+			else {
+				high = mid;
+			}
+		}
+		return low;
+	}
+
+	/// @return index of the entry with @p key or the count of entries, if not contained
+	uint32 find(const key_t key) const
+	{
+		const uint32 i = lower_bound(key);
+		return i < nodes.get_count()  &&  hash_t::comp(nodes[i].key, key) == 0 ? i : nodes.get_count();
+	}
+
+public:
+	iterator begin() { return nodes.begin(); }
+	iterator end() { return nodes.end(); }
+	const_iterator begin() const { return nodes.begin(); }
+	const_iterator end() const { return nodes.end(); }
+
+	void clear() { nodes.clear(); }
+
+	const value_t &get(const key_t key) const
+	{
+		static value_t nix;
+		const uint32 i = find(key);
+		return i < nodes.get_count() ? nodes[i].value : nix;
+	}
+
+	value_t *access(const key_t key)
+	{
+		const uint32 i = find(key);
+		return i < nodes.get_count() ? &nodes[i].value : NULL;
+	}
+
+	const value_t *access(const key_t key) const
+	{
+		const uint32 i = find(key);
+		return i < nodes.get_count() ? &nodes[i].value : NULL;
+	}
+
+	/// Inserts a new value - failure if key exists in table
+	bool put(const key_t key, value_t object)
+	{
+		const uint32 i = lower_bound(key);
+		if(  i < nodes.get_count()  &&  hash_t::comp(nodes[i].key, key) == 0  ) {
+			return false;
+		}
+		node_t n;
+		n.key = key;
+		n.value = object;
+		nodes.insert_at(i, n);
+		return true;
+	}
+
+	bool is_contained(const key_t key) const { return find(key) < nodes.get_count(); }
+
+	/// Replaces the value of an existing key or inserts it, returns the old value
+	value_t set(const key_t key, value_t object)
+	{
+		const uint32 i = find(key);
+		if(  i < nodes.get_count()  ) {
+			value_t value = nodes[i].value;
+			nodes[i].value = object;
+			return value;
+		}
+		put(key, object);
+		return value_t();
+	}
+
+	value_t remove(const key_t key)
+	{
+		const uint32 i = find(key);
+		if(  i < nodes.get_count()  ) {
+			value_t v = nodes[i].value;
+			nodes.remove_at(i);
+			return v;
+		}
+		return value_t();
+	}
+
+	uint32 get_count() const { return nodes.get_count(); }
+
+	bool empty() const { return nodes.empty(); }
+};
+
+
+#endif
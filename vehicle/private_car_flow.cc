@@ -0,0 +1,200 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#include "private_car_flow.h"
+
+#include "../simworld.h"
+#include "../simcity.h"
+#include "../simdebug.h"
+#include "../simunits.h"
+#include "../boden/grund.h"
+#include "../boden/wege/strasse.h"
+#include "../dataobj/environment.h"
+#include "../display/viewport.h"
+#include "../obj/gebaeude.h"
+#include "../utils/for.h"
+
+
+// safety limit against routes running in a circle
+#define MAX_FLOW_TILES (4096)
+
+vector_tpl<private_car_flow_t::trip_t> *private_car_flow_t::trips_added_threaded = NULL;
+uint32 private_car_flow_t::thread_count = 0;
+
+uint32 private_car_flow_t::month_trips = 0;
+uint32 private_car_flow_t::month_passages = 0;
+uint64 private_car_flow_t::month_ideal = 0;
+uint64 private_car_flow_t::month_actual = 0;
+
+
+void private_car_flow_t::init_threads(uint32 count)
+{
+	delete [] trips_added_threaded;
+	trips_added_threaded = new vector_tpl<trip_t>[count];
+	thread_count = count;
+}
+
+
+void private_car_flow_t::exit_threads()
+{
+	delete [] trips_added_threaded;
+	trips_added_threaded = NULL;
+	thread_count = 0;
+}
+
+
+bool private_car_flow_t::add_trip(koord3d start, koord target)
+{
+	const uint8 mode = world()->get_settings().get_private_car_flows();
+	if(  mode == 0  ) {
+		return true;
+	}
+
+	if(  mode == 1  &&  !env_t::networkmode  ) {
+		// still some cars to watch; in network games the view differs between the clients
+		const viewport_t *viewport = world()->get_viewport();
+		if(  viewport  &&  koord_distance(start.get_2d(), viewport->get_world_position()) <= env_t::private_car_flow_visible_radius  ) {
+			return true;
+		}
+	}
+
+	trip_t trip;
+	trip.start = start;
+	trip.target = target;
+#ifdef MULTI_THREAD
+	if(  trips_added_threaded  ) {
+		trips_added_threaded[karte_t::passenger_generation_thread_number].append(trip);
+	}
+#else
+	route_trip(trip, mode == 2);
+#endif
+	return mode == 2;
+}
+
+
+void private_car_flow_t::step()
+{
+	if(  trips_added_threaded == NULL  ) {
+		return;
+	}
+	const bool shadow = world()->get_settings().get_private_car_flows() == 2;
+	for(  uint32 i = 0;  i < thread_count;  i++  ) {
+		FOR(vector_tpl<trip_t>, const& trip, trips_added_threaded[i]) {
+			route_trip(trip, shadow);
+		}
+		trips_added_threaded[i].clear();
+	}
+}
+
+
+void private_car_flow_t::route_trip(const trip_t &trip, bool shadow)
+{
+	karte_t *const welt = world();
+
+	const grund_t *gr = welt->lookup(trip.start);
+	strasse_t *str = gr ? (strasse_t *)gr->get_weg(road_wt) : NULL;
+
+	// the same destinations as in private_car_t::hop_check()
+	const grund_t *gr_target = welt->lookup_kartenboden(trip.target);
+	const gebaeude_t *gb = gr_target ? gr_target->get_building() : NULL;
+	const stadt_t *destination_city = gb ? gb->get_stadt() : NULL;
+	const bool follow_routes = !welt->get_settings().get_assume_everywhere_connected_by_road();
+
+	month_trips++;
+	for(  uint32 n = 0;  str  &&  n < MAX_FLOW_TILES;  n++  ) {
+		book_passage(str, shadow);
+
+		// private cars are removed when close to their destination (private_car_t::enter_tile())
+		const koord pos = str->get_pos().get_2d();
+		if(  !follow_routes  ||  koord_distance(pos, trip.target) < 10  ) {
+			break;
+		}
+
+		koord3d next = koord3d::invalid;
+		if(  str->has_private_car_route(trip.target)  ) {
+			next = str->get_next_on_private_car_route_to(trip.target);
+		}
+		else if(  destination_city  ) {
+			const planquadrat_t *tile = welt->access(pos);
+			const stadt_t *current_city = tile ? tile->get_city() : NULL;
+			if(  current_city != destination_city  &&  str->has_private_car_route(destination_city->get_townhall_road())  ) {
+				next = str->get_next_on_private_car_route_to(destination_city->get_townhall_road());
+			}
+		}
+		if(  next == koord3d::invalid  ) {
+			// end of the route: a car would now search its way by itself
+			break;
+		}
+
+		gr = welt->lookup(next);
+		str = gr ? (strasse_t *)gr->get_weg(road_wt) : NULL;
+	}
+}
+
+
+void private_car_flow_t::book_passage(strasse_t *str, bool shadow)
+{
+	karte_t *const welt = world();
+
+	const sint32 speed_limit = min(welt->get_citycar_speed_average(), str->get_max_speed());
+	if(  speed_limit <= 0  ) {
+		return;
+	}
+	const uint32 ideal = (1 << YARDS_PER_TILE_SHIFT) / kmh_to_speed(speed_limit);
+
+	// Trips per tick over the last and this month. Cars do not enter a tile occupied
+	// by a car in the same lane, so the two lanes can take 2/ideal cars per tick.
+	const sint64 passages = (sint64)max(0, str->get_statistics(WAY_STAT_CONVOIS)) + max(0, str->get_current_statistics(WAY_STAT_CONVOIS));
+	const sint64 ticks = welt->ticks_per_world_month + (welt->get_ticks() & (welt->ticks_per_world_month - 1));
+
+	// volume/capacity (1024 = 1), travel time = ideal * (1 + 0.15 * (volume/capacity)^4)
+	sint64 ratio = (passages * ideal * 1024) / (2 * ticks);
+	if(  ratio > 4096  ) {
+		ratio = 4096;
+	}
+	const sint64 ratio2 = (ratio * ratio) >> 10;
+	const sint64 ratio4 = (ratio2 * ratio2) >> 10;
+	const uint32 actual = (uint32)(((sint64)ideal * (1024 + (ratio4 * 15) / 100)) >> 10);
+
+	if(  !shadow  ) {
+		str->book(1, WAY_STAT_CONVOIS);
+		str->update_travel_times(actual, ideal);
+	}
+
+	month_passages++;
+	month_ideal += ideal;
+	month_actual += actual;
+}
+
+
+static uint32 congestion_percentage(uint64 actual, uint64 ideal)
+{
+	return actual > ideal ? (uint32)(actual * 100 / ideal) - 100 : 0;
+}
+
+
+void private_car_flow_t::new_month()
+{
+	const uint8 mode = world()->get_settings().get_private_car_flows();
+	if(  mode != 0  ) {
+		// the measured travel times of all roads (cars, flows and road vehicles) for comparison
+		uint64 road_ideal = 0;
+		uint64 road_actual = 0;
+		FOR(vector_tpl<weg_t *>, const w, weg_t::get_alle_wege()) {
+			if(  w->get_waytype() == road_wt  ) {
+				road_ideal += w->get_travel_time(WAY_STAT_LAST_MONTH, WAY_TRAVEL_TIME_IDEAL);
+				road_actual += w->get_travel_time(WAY_STAT_LAST_MONTH, WAY_TRAVEL_TIME_ACTUAL);
+			}
+		}
+		dbg->message( "private_car_flow_t::new_month()", "%u trips %s as flows over %u road tiles: congestion of the flows %u%%, measured on all roads %u%%",
+			month_trips, mode == 2 ? "calculated" : "routed", month_passages,
+			congestion_percentage(month_actual, month_ideal), congestion_percentage(road_actual, road_ideal) );
+	}
+
+	month_trips = 0;
+	month_passages = 0;
+	month_ideal = 0;
+	month_actual = 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * This file is part of the Simutrans-Extended project under the Artistic License.
+ * (see LICENSE.txt)
+ */
+
+#ifndef VEHICLE_PRIVATE_CAR_FLOW_H
+#define VEHICLE_PRIVATE_CAR_FLOW_H
+
+
+#include "../simtypes.h"
+#include "../dataobj/koord.h"
+#include "../dataobj/koord3d.h"
+#include "../tpl/vector_tpl.h"
+
+class strasse_t;
+
+
+/**
+ * Aggregate private car traffic for very large maps (settings: private_car_flows).
+ *
+ * Instead of creating a private_car_t for every trip, the trip is routed over
+ * the private car routes of the roads. Every road tile on the way books the trip
+ * in its statistics and a travel time, which grows with the number of trips over
+ * this tile in the current and the last month (volume/delay function as used in
+ * traffic planning). Thus the congestion of the cities is still measured.
+ *
+ * The trips of the passenger generation threads are collected and routed by the
+ * main thread in a fixed order, so network games stay in sync.
+ */
+class private_car_flow_t
+{
+public:
+	/**
+	 * Called for each private car trip by the passenger generation.
+	 * @return true if the trip is also driven by a private_car_t
+	 */
+	static bool add_trip(koord3d start, koord target);
+
+	/// routes the trips of this step, called after the passenger generation
+	static void step();
+
+	/// logs the congestion of the flows and the measured congestion of all roads of the last month
+	static void new_month();
+
+	static void init_threads(uint32 count);
+	static void exit_threads();
+
+private:
+	struct trip_t
+	{
+		koord3d start;
+		koord target;
+	};
+
+	/// the trips of each passenger generation thread
+	static vector_tpl<trip_t> *trips_added_threaded;
+	static uint32 thread_count;
+
+	/// statistics of this month for the log
+	static uint32 month_trips;
+	static uint32 month_passages;
+	static uint64 month_ideal;
+	static uint64 month_actual;
+
+	/// @param shadow only calculate the statistics, do not change the roads
+	static void route_trip(const trip_t &trip, bool shadow);
+
+	static void book_passage(strasse_t *str, bool shadow);
+};
+
+#endif
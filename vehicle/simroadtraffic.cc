@@ -746,26 +746,24 @@ bool private_car_t::can_enter_tile(grund_t *gr)
 			sg[0] = welt->lookup(pos_next);
 			sg[1] = welt->lookup(pos_next_next);
 			for(uint8 i = 0; i < 2; i++) {
-				for(  uint8 pos=1;  sg[i] && pos < sg[i]->get_top();  pos++  ) {
-					if(  vehicle_base_t* const v = obj_cast<vehicle_base_t>(sg[i]->obj_bei(pos))  ) {
-						ribi_t:: ribi other_direction = 255;
-						if(  road_vehicle_t const* const at = obj_cast<road_vehicle_t>(v)  ) {
-							if(  at && !at->get_convoi()->is_overtaking()  ) {
-								other_direction = at->get_direction();
-							}
+				FOR(minivec_tpl<vehicle_base_t *>, const v, strasse_t::get_road_users(sg[i])) {
+					ribi_t:: ribi other_direction = 255;
+					if(  road_vehicle_t const* const at = obj_cast<road_vehicle_t>(v)  ) {
+						if(  at && !at->get_convoi()->is_overtaking()  ) {
+							other_direction = at->get_direction();
 						}
-						else if(  private_car_t* const caut = obj_cast<private_car_t>(v)  ) {
-							if(  !caut->is_overtaking()  ) {
-								other_direction = caut->get_direction();
-							}
+					}
+					else if(  private_car_t* const caut = obj_cast<private_car_t>(v)  ) {
+						if(  !caut->is_overtaking()  ) {
+							other_direction = caut->get_direction();
 						}
-						if(  other_direction!=255  ) {
-							if(  i==0  &&  ribi_t::reverse_single(get_90direction())==other_direction  ) {
-								set_tiles_overtaking(0);
-							}
-							if(  i==1  &&  ribi_t::reverse_single(ribi_type(pos_next, pos_next_next))==other_direction  ) {
-								set_tiles_overtaking(0);
-							}
+					}
+					if(  other_direction!=255  ) {
+						if(  i==0  &&  ribi_t::reverse_single(get_90direction())==other_direction  ) {
+							set_tiles_overtaking(0);
+						}
+						if(  i==1  &&  ribi_t::reverse_single(ribi_type(pos_next, pos_next_next))==other_direction  ) {
+							set_tiles_overtaking(0);
 						}
 					}
 				}
@@ -1510,20 +1508,17 @@ bool private_car_t::can_overtake( overtaker_t *other_overtaker, sint32 other_spe
 			}
 			if(  overtaking_mode > oneway_mode  ) {
 				// Check for other vehicles on the next tile
-				const uint8 top = gr->get_top();
-				for(  uint8 j=1;  j<top;  j++  ) {
-					if(  vehicle_base_t* const v = obj_cast<vehicle_base_t>(gr->obj_bei(j))  ) {
-						// check for other traffic on the road
-						const overtaker_t *ov = v->get_overtaker();
-						if(ov) {
-							if(this!=ov  &&  other_overtaker!=ov) {
-								return false;
-							}
-						}
-						else if(  v->get_waytype()==road_wt  &&  v->get_typ()!=obj_t::pedestrian  ) {
+				FOR(minivec_tpl<vehicle_base_t *>, const v, strasse_t::get_road_users(gr)) {
+					// check for other traffic on the road
+					const overtaker_t *ov = v->get_overtaker();
+					if(ov) {
+						if(this!=ov  &&  other_overtaker!=ov) {
 							return false;
 						}
 					}
+					else {
+						return false;
+					}
 				}
 			}
 			check_pos += koord(direction);
@@ -1636,27 +1631,24 @@ bool private_car_t::can_overtake( overtaker_t *other_overtaker, sint32 other_spe
 		}
 
 		// Check for other vehicles on the next tile
-		const uint8 top = gr->get_top();
-		for(  uint8 j=1;  j<top;  j++  ) {
-			if(  vehicle_base_t* const v = obj_cast<vehicle_base_t>(gr->obj_bei(j))  ) {
-				// check for other traffic on the road
-				const overtaker_t *ov = v->get_overtaker();
-				if(ov) {
-					if(this!=ov  &&  other_overtaker!=ov) {
-						if(  static_cast<strasse_t*>(gr->get_weg(road_wt))->get_overtaking_mode() <= oneway_mode  ) {
-							//If ov goes same directory, should not return false
-							if (v && v->get_direction() != direction && v->get_overtaker()) {
-								return false;
-							}
-						}
-						else {
+		FOR(minivec_tpl<vehicle_base_t *>, const v, strasse_t::get_road_users(gr)) {
+			// check for other traffic on the road
+			const overtaker_t *ov = v->get_overtaker();
+			if(ov) {
+				if(this!=ov  &&  other_overtaker!=ov) {
+					if(  static_cast<strasse_t*>(gr->get_weg(road_wt))->get_overtaking_mode() <= oneway_mode  ) {
+						//If ov goes same directory, should not return false
+						if (v && v->get_direction() != direction && v->get_overtaker()) {
 							return false;
 						}
 					}
+					else {
+						return false;
+					}
 				}
-				else if(  v->get_waytype()==road_wt  &&  v->get_typ()!=obj_t::pedestrian  ) {
-					return false;
-				}
+			}
+			else {
+				return false;
 			}
 		}
 
@@ -1719,10 +1711,8 @@ bool private_car_t::can_overtake( overtaker_t *other_overtaker, sint32 other_spe
 		// Check for other vehicles in facing direction
 		// now only I know direction on this tile ...
 		ribi_t::ribi their_direction = ribi_t::backward(calc_direction( pos_prev_prev, to->get_pos()));
-		const uint8 top = gr->get_top();
-		for(  uint8 j=1;  j<top;  j++ ) {
-			vehicle_base_t* const v = obj_cast<vehicle_base_t>(gr->obj_bei(j));
-			if(  v  &&  v->get_direction() == their_direction  ) {
+		FOR(minivec_tpl<vehicle_base_t *>, const v, strasse_t::get_road_users(gr)) {
+			if(  v->get_direction() == their_direction  ) {
 				// check for car
 				if(v->get_overtaker()) {
 					return false;
@@ -1779,42 +1769,37 @@ vehicle_base_t* private_car_t::is_there_car (grund_t *gr) const
 		dbg->error( "private_car_t::is_there_car", "grund is invalid!" );
 	}
 	assert(  gr  );
-	for(  uint8 pos=1;  pos < gr->get_top();  pos++  ) {
-		if(  vehicle_base_t* const v = obj_cast<vehicle_base_t>(gr->obj_bei(pos))  ) {
-			if(  v->get_typ()==obj_t::pedestrian  ) {
+	FOR(minivec_tpl<vehicle_base_t *>, const v, strasse_t::get_road_users(gr)) {
+		if(  road_vehicle_t const* const at = obj_cast<road_vehicle_t>(v)  ) {
+			if(  is_overtaking() && at->get_convoi()->is_overtaking()  ){
 				continue;
 			}
-			if(  road_vehicle_t const* const at = obj_cast<road_vehicle_t>(v)  ) {
-				if(  is_overtaking() && at->get_convoi()->is_overtaking()  ){
-					continue;
-				}
-				if(  !is_overtaking() && !(at->get_convoi()->is_overtaking())  ){
-					//Prohibit going on passing lane when facing traffic exists.
-					ribi_t::ribi other_direction = at->get_direction();
-					if(  ribi_t::backward(get_direction()) == other_direction  ) {
-						return v;
-					}
-					continue;
+			if(  !is_overtaking() && !(at->get_convoi()->is_overtaking())  ){
+				//Prohibit going on passing lane when facing traffic exists.
+				ribi_t::ribi other_direction = at->get_direction();
+				if(  ribi_t::backward(get_direction()) == other_direction  ) {
+					return v;
 				}
-				// speed zero check must be done by parent function.
-				return v;
+				continue;
 			}
-			else if(  private_car_t* const caut = obj_cast<private_car_t>(v)  ) {
-				if(  is_overtaking() && caut->is_overtaking()  ){
-					continue;
-				}
-				if(  !is_overtaking() && !(caut->is_overtaking())  )
-				{
-					// Prohibit going on passing lane when facing traffic exists.
-					ribi_t::ribi other_direction = caut->get_direction();
-					if( ribi_t::backward(get_direction()) == other_direction  ) {
-						return v;
-					}
-					continue;
+			// speed zero check must be done by parent function.
+			return v;
+		}
+		else if(  private_car_t* const caut = obj_cast<private_car_t>(v)  ) {
+			if(  is_overtaking() && caut->is_overtaking()  ){
+				continue;
+			}
+			if(  !is_overtaking() && !(caut->is_overtaking())  )
+			{
+				// Prohibit going on passing lane when facing traffic exists.
+				ribi_t::ribi other_direction = caut->get_direction();
+				if( ribi_t::backward(get_direction()) == other_direction  ) {
+					return v;
 				}
-				// speed zero check must be done by parent function.
-				return v;
+				continue;
 			}
+			// speed zero check must be done by parent function.
+			return v;
 		}
 	}
 	return NULL;
@@ -643,82 +643,76 @@ vehicle_base_t *vehicle_base_t::get_blocking_vehicle(const grund_t *gr, const co
 		break;
 	}
 	// Search vehicle
-	for(  uint8 pos=1;  pos < gr->get_top();  pos++  ) {
-		if(  vehicle_base_t* const v = obj_cast<vehicle_base_t>(gr->obj_bei(pos))  ) {
-			if(  v->get_typ()==obj_t::pedestrian  ) {
+	FOR(minivec_tpl<vehicle_base_t *>, const v, strasse_t::get_road_users(gr)) {
+		// check for car
+		uint8 other_direction=255;
+		bool other_moving = false;
+		bool other_overtaking = false; //whether the other convoi is on passing lane.
+		if(  road_vehicle_t const* const at = obj_cast<road_vehicle_t>(v)  ) {
+			// ignore ourself
+			if(  cnv == at->get_convoi()  ) {
 				continue;
 			}
-
-			// check for car
-			uint8 other_direction=255;
-			bool other_moving = false;
-			bool other_overtaking = false; //whether the other convoi is on passing lane.
-			if(  road_vehicle_t const* const at = obj_cast<road_vehicle_t>(v)  ) {
-				// ignore ourself
-				if(  cnv == at->get_convoi()  ) {
-					continue;
-				}
-				other_direction = at->get_direction();
-				other_moving = at->get_convoi()->get_akt_speed() > kmh_to_speed(1);
-				other_overtaking = at->get_convoi()->is_overtaking();
-			}
-			// check for city car
-			else if(  v->get_waytype() == road_wt  ) {
-				other_direction = v->get_direction();
-				if(  private_car_t const* const sa = obj_cast<private_car_t>(v)  ){
-					if(  pcar == sa  ) {
-						continue; // ignore ourself
-					}
-					other_moving = sa->get_current_speed() > 1;
-					other_overtaking = sa->is_overtaking();
+			other_direction = at->get_direction();
+			other_moving = at->get_convoi()->get_akt_speed() > kmh_to_speed(1);
+			other_overtaking = at->get_convoi()->is_overtaking();
+		}
+		// check for city car
+		else if(  v->get_waytype() == road_wt  ) {
+			other_direction = v->get_direction();
+			if(  private_car_t const* const sa = obj_cast<private_car_t>(v)  ){
+				if(  pcar == sa  ) {
+					continue; // ignore ourself
 				}
+				other_moving = sa->get_current_speed() > 1;
+				other_overtaking = sa->is_overtaking();
 			}
+		}
 
-			// ok, there is another car ...
-			if(  other_direction != 255  ) {
-				if(  next_direction == other_direction  &&  !ribi_t::is_threeway(gr->get_weg_ribi(road_wt))  &&  cnv_overtaking == other_overtaking  ) {
-					// only consider cars on same lane.
-					// cars going in the same direction and no crossing => that mean blocking ...
-					return v;
-				}
-
-				const ribi_t::ribi other_90direction = (gr->get_pos().get_2d() == v->get_pos_next().get_2d()) ? other_direction : calc_direction(gr->get_pos(),v->get_pos_next());
-				if(  other_90direction == next_90direction  &&  cnv_overtaking == other_overtaking  ) {
-					// Want to exit in same as other   ~50% of the time
-					return v;
-				}
+		// ok, there is another car ...
+		if(  other_direction != 255  ) {
+			if(  next_direction == other_direction  &&  !ribi_t::is_threeway(gr->get_weg_ribi(road_wt))  &&  cnv_overtaking == other_overtaking  ) {
+				// only consider cars on same lane.
+				// cars going in the same direction and no crossing => that mean blocking ...
+				return v;
+			}
 
-				const bool across = next_direction == (drives_on_left ? ribi_t::rotate45l(next_90direction) : ribi_t::rotate45(next_90direction)); // turning across the opposite directions lane
-				const bool other_across = other_direction == (drives_on_left ? ribi_t::rotate45l(other_90direction) : ribi_t::rotate45(other_90direction)); // other is turning across the opposite directions lane
-				if(  other_direction == next_direction  &&  !(other_across || across)  &&  cnv_overtaking == other_overtaking  ) {
-					// only consider cars on same lane.
-					// entering same straight waypoint as other ~18%
-					return v;
-				}
+			const ribi_t::ribi other_90direction = (gr->get_pos().get_2d() == v->get_pos_next().get_2d()) ? other_direction : calc_direction(gr->get_pos(),v->get_pos_next());
+			if(  other_90direction == next_90direction  &&  cnv_overtaking == other_overtaking  ) {
+				// Want to exit in same as other   ~50% of the time
+				return v;
+			}
 
-				const bool straight = next_direction == next_90direction; // driving straight
-				const ribi_t::ribi current_90direction = straight ? ribi_t::backward(next_90direction) : (~(next_direction|ribi_t::backward(next_90direction)))&0x0F;
-				const bool other_straight = other_direction == other_90direction; // other is driving straight
-				const bool other_exit_same_side = current_90direction == other_90direction; // other is exiting same side as we're entering
-				const bool other_exit_opposite_side = ribi_t::backward(current_90direction) == other_90direction; // other is exiting side across from where we're entering
-				if(  across  &&  ((ribi_t::is_perpendicular(current_90direction,other_direction)  &&  other_moving)  ||  (other_across  &&  other_exit_opposite_side)  ||  ((other_across  ||  other_straight)  &&  other_exit_same_side  &&  other_moving) ) )  {
-					// other turning across in front of us from orth entry dir'n   ~4%
-					return v;
-				}
+			const bool across = next_direction == (drives_on_left ? ribi_t::rotate45l(next_90direction) : ribi_t::rotate45(next_90direction)); // turning across the opposite directions lane
+			const bool other_across = other_direction == (drives_on_left ? ribi_t::rotate45l(other_90direction) : ribi_t::rotate45(other_90direction)); // other is turning across the opposite directions lane
+			if(  other_direction == next_direction  &&  !(other_across || across)  &&  cnv_overtaking == other_overtaking  ) {
+				// only consider cars on same lane.
+				// entering same straight waypoint as other ~18%
+				return v;
+			}
 
-				const bool headon = ribi_t::backward(current_direction) == other_direction; // we're meeting the other headon
-				const bool other_exit_across = (drives_on_left ? ribi_t::rotate90l(next_90direction) : ribi_t::rotate90(next_90direction)) == other_90direction; // other is exiting by turning across the opposite directions lane
-				if(  straight  &&  (ribi_t::is_perpendicular(current_90direction,other_direction)  ||  (other_across  &&  other_moving  &&  (other_exit_across  ||  (other_exit_same_side  &&  !headon))) ) ) {
-					// other turning across in front of us, but allow if other is stopped - duplicating historic behaviour   ~2%
-					return v;
-				}
-				else if(  other_direction == current_direction  &&  current_90direction == ribi_t::none  &&  cnv_overtaking == other_overtaking  ) {
-					// entering same diagonal waypoint as other   ~1%
-					return v;
-				}
+			const bool straight = next_direction == next_90direction; // driving straight
+			const ribi_t::ribi current_90direction = straight ? ribi_t::backward(next_90direction) : (~(next_direction|ribi_t::backward(next_90direction)))&0x0F;
+			const bool other_straight = other_direction == other_90direction; // other is driving straight
+			const bool other_exit_same_side = current_90direction == other_90direction; // other is exiting same side as we're entering
+			const bool other_exit_opposite_side = ribi_t::backward(current_90direction) == other_90direction; // other is exiting side across from where we're entering
+			if(  across  &&  ((ribi_t::is_perpendicular(current_90direction,other_direction)  &&  other_moving)  ||  (other_across  &&  other_exit_opposite_side)  ||  ((other_across  ||  other_straight)  &&  other_exit_same_side  &&  other_moving) ) )  {
+				// other turning across in front of us from orth entry dir'n   ~4%
+				return v;
+			}
 
-				// else other car is not blocking   ~25%
+			const bool headon = ribi_t::backward(current_direction) == other_direction; // we're meeting the other headon
+			const bool other_exit_across = (drives_on_left ? ribi_t::rotate90l(next_90direction) : ribi_t::rotate90(next_90direction)) == other_90direction; // other is exiting by turning across the opposite directions lane
+			if(  straight  &&  (ribi_t::is_perpendicular(current_90direction,other_direction)  ||  (other_across  &&  other_moving  &&  (other_exit_across  ||  (other_exit_same_side  &&  !headon))) ) ) {
+				// other turning across in front of us, but allow if other is stopped - duplicating historic behaviour   ~2%
+				return v;
+			}
+			else if(  other_direction == current_direction  &&  current_90direction == ribi_t::none  &&  cnv_overtaking == other_overtaking  ) {
+				// entering same diagonal waypoint as other   ~1%
+				return v;
 			}
+
+			// else other car is not blocking   ~25%
 		}
 	}
 
@@ -3829,35 +3823,30 @@ bool road_vehicle_t::can_enter_tile(const grund_t *gr, sint32 &restart_speed, ui
 					cnv->suche_neue_route();
 					return false;
 				}
-				for(  uint8 pos=1;  pos < grn->get_top();  pos++  ){
-					if(  vehicle_base_t* const v = obj_cast<vehicle_base_t>(grn->obj_bei(pos))  ){
-						if(  v->get_typ()==obj_t::pedestrian  ) {
+				FOR(minivec_tpl<vehicle_base_t *>, const v, strasse_t::get_road_users(grn)) {
+					ribi_t::ribi other_direction=255;
+					if(  road_vehicle_t const* const at = obj_cast<road_vehicle_t>(v)  ) {
+						//ignore ourself
+						if(  cnv == at->get_convoi()  ||  at->get_convoi()->is_overtaking()  ){
 							continue;
 						}
-						ribi_t::ribi other_direction=255;
-						if(  road_vehicle_t const* const at = obj_cast<road_vehicle_t>(v)  ) {
-							//ignore ourself
-							if(  cnv == at->get_convoi()  ||  at->get_convoi()->is_overtaking()  ){
-								continue;
-							}
-							other_direction = at->get_90direction();
-						}
-						//check for city car
-						else if(  private_car_t* const caut = obj_cast<private_car_t>(v)  ) {
-							if(  caut->is_overtaking()  ) {
-								continue;
-							}
-							other_direction = v->get_90direction();
+						other_direction = at->get_90direction();
+					}
+					//check for city car
+					else if(  private_car_t* const caut = obj_cast<private_car_t>(v)  ) {
+						if(  caut->is_overtaking()  ) {
+							continue;
 						}
-						if(  other_direction != 255  ){
-							//There is another car. We have to check if this convoi is facing or not.
-							ribi_t::ribi this_direction = 0;
-							if(  test_index-route_index==0  ) this_direction = get_90direction();
-							if(  test_index-route_index==1  ) this_direction = get_next_90direction();
-							if(  ribi_t::reverse_single(this_direction) == other_direction  ) {
-								//printf("%s: crash avoid. (%d,%d)\n", cnv->get_name(), get_pos().x, get_pos().y);
-								cnv->set_tiles_overtaking(0);
-							}
+						other_direction = v->get_90direction();
+					}
+					if(  other_direction != 255  ){
+						//There is another car. We have to check if this convoi is facing or not.
+						ribi_t::ribi this_direction = 0;
+						if(  test_index-route_index==0  ) this_direction = get_90direction();
+						if(  test_index-route_index==1  ) this_direction = get_next_90direction();
+						if(  ribi_t::reverse_single(this_direction) == other_direction  ) {
+							//printf("%s: crash avoid. (%d,%d)\n", cnv->get_name(), get_pos().x, get_pos().y);
+							cnv->set_tiles_overtaking(0);
 						}
 					}
 				}
@@ -4294,78 +4283,73 @@ vehicle_base_t* road_vehicle_t::other_lane_blocked(const bool only_search_top, s
 				break;
 			}
 
-			for(  uint8 pos=1;  pos < gr->get_top();  pos++  ) {
-				if(  vehicle_base_t* const v = obj_cast<vehicle_base_t>(gr->obj_bei(pos))  ) {
-					if(  v->get_typ()==obj_t::pedestrian  ) {
+			FOR(minivec_tpl<vehicle_base_t *>, const v, strasse_t::get_road_users(gr)) {
+				if(  road_vehicle_t const* const at = obj_cast<road_vehicle_t>(v)  ) {
+					// ignore ourself
+					if(  cnv == at->get_convoi()  ) {
 						continue;
 					}
-					if(  road_vehicle_t const* const at = obj_cast<road_vehicle_t>(v)  ) {
-						// ignore ourself
-						if(  cnv == at->get_convoi()  ) {
-							continue;
-						}
-						if(  cnv->is_overtaking() && at->get_convoi()->is_overtaking()  ){
-							continue;
-						}
-						if(  !cnv->is_overtaking() && !(at->get_convoi()->is_overtaking())  ){
-							//Prohibit going on passing lane when facing traffic exists.
-							ribi_t::ribi other_direction = at->get_direction();
-							route_t const& r = *cnv->get_route();
-							koord3d next = route_index < r.get_count() - 1u ? r.at(route_index + 1u) : pos_next;
-							if(  calc_direction(next,get_pos()) == other_direction  ) {
-								return v;
-							}
-							continue;
-						}
-						// the logic of other_lane_blocked cannot be applied to facing traffic.
-						if(test_index>0) {
-							const ribi_t::ribi this_prev_dir = calc_direction(r.at(test_index-1u), r.at(test_index));
-							if(ribi_t::backward(this_prev_dir)&at->get_previous_direction()) {
-								continue;
-							}
-						}
-						// Ignore stopping convoi on the tile behind this convoi to change lane in traffic jam.
-						if(  can_reach_tail  &&  at->get_convoi()->get_akt_speed() == 0  ) {
-							continue;
-						}
-						if(  test_index==tail_index-1+offset  ||  test_index==tail_index+offset  ){
-							uint8 tail_offset = 0;
-							if(  test_index==tail_index-1+offset  ) tail_offset = 1;
-							if(  test_index+tail_offset>=1  &&  test_index+tail_offset<(sint32)r.get_count()-1  &&   judge_lane_crossing(calc_direction(r.at(test_index-1u+tail_offset),r.at(test_index+tail_offset)), calc_direction(r.at(test_index+tail_offset),r.at(test_index+1u+tail_offset)),  v->get_90direction(), cnv->is_overtaking(), true)  ){
-								return v;
-							}
-							continue;
+					if(  cnv->is_overtaking() && at->get_convoi()->is_overtaking()  ){
+						continue;
+					}
+					if(  !cnv->is_overtaking() && !(at->get_convoi()->is_overtaking())  ){
+						//Prohibit going on passing lane when facing traffic exists.
+						ribi_t::ribi other_direction = at->get_direction();
+						route_t const& r = *cnv->get_route();
+						koord3d next = route_index < r.get_count() - 1u ? r.at(route_index + 1u) : pos_next;
+						if(  calc_direction(next,get_pos()) == other_direction  ) {
+							return v;
 						}
-						return v;
+						continue;
 					}
-					else if(  private_car_t* const caut = obj_cast<private_car_t>(v)  ) {
-						if(  cnv->is_overtaking() && caut->is_overtaking()  ){
+					// the logic of other_lane_blocked cannot be applied to facing traffic.
+					if(test_index>0) {
+						const ribi_t::ribi this_prev_dir = calc_direction(r.at(test_index-1u), r.at(test_index));
+						if(ribi_t::backward(this_prev_dir)&at->get_previous_direction()) {
 							continue;
 						}
-						if(  !cnv->is_overtaking() && !(caut->is_overtaking())  ){
-							//Prohibit going on passing lane when facing traffic exists.
-							ribi_t::ribi other_direction = caut->get_direction();
-							route_t const& r = *cnv->get_route();
-							koord3d next = route_index < r.get_count() - 1u ? r.at(route_index + 1u) : pos_next;
-							if(  calc_direction(next,get_pos()) == other_direction  ) {
-								return v;
-							}
-							continue;
+					}
+					// Ignore stopping convoi on the tile behind this convoi to change lane in traffic jam.
+					if(  can_reach_tail  &&  at->get_convoi()->get_akt_speed() == 0  ) {
+						continue;
+					}
+					if(  test_index==tail_index-1+offset  ||  test_index==tail_index+offset  ){
+						uint8 tail_offset = 0;
+						if(  test_index==tail_index-1+offset  ) tail_offset = 1;
+						if(  test_index+tail_offset>=1  &&  test_index+tail_offset<(sint32)r.get_count()-1  &&   judge_lane_crossing(calc_direction(r.at(test_index-1u+tail_offset),r.at(test_index+tail_offset)), calc_direction(r.at(test_index+tail_offset),r.at(test_index+1u+tail_offset)),  v->get_90direction(), cnv->is_overtaking(), true)  ){
+							return v;
 						}
-						// Ignore stopping convoi on the tile behind this convoi to change lane in traffic jam.
-						if(  can_reach_tail  &&  caut->get_current_speed() == 0  ) {
-							continue;
+						continue;
+					}
+					return v;
+				}
+				else if(  private_car_t* const caut = obj_cast<private_car_t>(v)  ) {
+					if(  cnv->is_overtaking() && caut->is_overtaking()  ){
+						continue;
+					}
+					if(  !cnv->is_overtaking() && !(caut->is_overtaking())  ){
+						//Prohibit going on passing lane when facing traffic exists.
+						ribi_t::ribi other_direction = caut->get_direction();
+						route_t const& r = *cnv->get_route();
+						koord3d next = route_index < r.get_count() - 1u ? r.at(route_index + 1u) : pos_next;
+						if(  calc_direction(next,get_pos()) == other_direction  ) {
+							return v;
 						}
-						if(  test_index==tail_index-1+offset  ||  test_index==tail_index+offset  ){
-							uint8 tail_offset = 0;
-							if(  test_index==tail_index-1+offset  ) tail_offset = 1;
-							if(  test_index+tail_offset>=1  &&  test_index+tail_offset<(sint32)r.get_count()-1  &&   judge_lane_crossing(calc_direction(r.at(test_index-1u+tail_offset),r.at(test_index+tail_offset)), calc_direction(r.at(test_index+tail_offset),r.at(test_index+1u+tail_offset)),  v->get_90direction(), cnv->is_overtaking(), true)  ){
-								return v;
-							}
-							continue;
+						continue;
+					}
+					// Ignore stopping convoi on the tile behind this convoi to change lane in traffic jam.
+					if(  can_reach_tail  &&  caut->get_current_speed() == 0  ) {
+						continue;
+					}
+					if(  test_index==tail_index-1+offset  ||  test_index==tail_index+offset  ){
+						uint8 tail_offset = 0;
+						if(  test_index==tail_index-1+offset  ) tail_offset = 1;
+						if(  test_index+tail_offset>=1  &&  test_index+tail_offset<(sint32)r.get_count()-1  &&   judge_lane_crossing(calc_direction(r.at(test_index-1u+tail_offset),r.at(test_index+tail_offset)), calc_direction(r.at(test_index+tail_offset),r.at(test_index+1u+tail_offset)),  v->get_90direction(), cnv->is_overtaking(), true)  ){
+							return v;
 						}
-						return v;
+						continue;
 					}
+					return v;
 				}
 			}
 			if(  test_index==tail_index-1+offset  ){
@@ -6014,6 +5998,12 @@ sint32 rail_vehicle_t::block_reserver(route_t *route, uint16 start_index, uint16
 	roadsign_t::signal_aspects first_time_interval_state = roadsign_t::advance_caution; // A time interval signal will never be in advance caution, so this is a placeholder to indicate that this value has not been set.
 	signal_t* station_signal_to_clear_for_entry = NULL;
 
+	// These do not change while reserving, so look them up only once when first needed rather than on every tile.
+	const signal_t* moving_block_signal = NULL;
+	bool moving_block_signal_found = false;
+	halthandle_t current_entry_halt;
+	bool current_entry_halt_found = false;
+
 	if(working_method == drive_by_sight)
 	{
 		const sint32 max_speed_drive_by_sight = get_desc()->get_waytype() == tram_wt ? welt->get_settings().get_max_speed_drive_by_sight_tram() : welt->get_settings().get_max_speed_drive_by_sight();
@@ -6118,8 +6108,13 @@ sint32 rail_vehicle_t::block_reserver(route_t *route, uint16 start_index, uint16
 			if(working_method == moving_block)
 			{
 				// Continue in moving block if in range of the most recent moving block signal.
-				const grund_t* gr_last_signal = welt->lookup(cnv->get_last_signal_pos());
-				const signal_t* sg = gr_last_signal ? gr_last_signal->find<signal_t>() : NULL;
+				if(!moving_block_signal_found)
+				{
+					const grund_t* gr_last_signal = welt->lookup(cnv->get_last_signal_pos());
+					moving_block_signal = gr_last_signal ? gr_last_signal->find<signal_t>() : NULL;
+					moving_block_signal_found = true;
+				}
+				const signal_t* sg = moving_block_signal;
 				if(!sg || sg->get_desc()->get_max_distance_to_signalbox() < shortest_distance(pos.get_2d(), cnv->get_last_signal_pos().get_2d()))
 				{
 					// Out of range of the moving block beacon/signal; revert to drive by sight
@@ -6172,9 +6167,13 @@ sint32 rail_vehicle_t::block_reserver(route_t *route, uint16 start_index, uint16
 
 			if(!signal_here && station_signals_ahead)
 			{
-				halthandle_t destination_halt = haltestelle_t::get_halt(cnv->get_schedule()->get_current_entry().pos, get_owner());
-				station_signals_in_advance = check_halt != this_halt && check_halt != destination_halt;
-				if (check_halt != this_halt && check_halt == destination_halt)
+				if(!current_entry_halt_found)
+				{
+					current_entry_halt = haltestelle_t::get_halt(cnv->get_schedule()->get_current_entry().pos, get_owner());
+					current_entry_halt_found = true;
+				}
+				station_signals_in_advance = check_halt != this_halt && check_halt != current_entry_halt;
+				if (check_halt != this_halt && check_halt == current_entry_halt)
 				{
 					station_signal_to_clear_only = true;
 				}
@@ -6828,7 +6827,7 @@ sint32 rail_vehicle_t::block_reserver(route_t *route, uint16 start_index, uint16
 			bool attempt_reservation = directional_only || time_interval_reservation || previous_telegraph_directional || ((next_signal_working_method != time_interval && next_signal_working_method != time_interval_with_telegraph && ((next_signal_working_method != drive_by_sight && !transitioning_from_time_interval) || i < start_index + modified_sighting_distance_tiles + 1)) && (!stop_at_station_signal.is_bound() || stop_at_station_signal == check_halt));
 			previous_telegraph_directional = telegraph_directional;
 			previous_time_interval_reservation = time_interval_reservation ? is_true : is_false;
-			if(!reserving_beyond_a_train && attempt_reservation && !sch1->reserve(cnv->self, ribi_type(route->at(max(1u,i)-1u), route->at(min(route->get_count()-1u,i+1u))), rt, (working_method == time_interval || working_method == time_interval_with_telegraph)))
+			if(!reserving_beyond_a_train && attempt_reservation && !sch1->reserve(cnv->self, ribi, rt, (working_method == time_interval || working_method == time_interval_with_telegraph)))
 			{
 				not_entirely_free = true;
 				if (from_call_on)
@@ -6890,7 +6889,7 @@ sint32 rail_vehicle_t::block_reserver(route_t *route, uint16 start_index, uint16
 					&& !directional_only
 					&& ((next_signal_index <= last_stop_signal_before_first_bidirectional_signal_index
 					&& last_stop_signal_before_first_bidirectional_signal_index < INVALID_INDEX)
-					|| sch1->can_reserve(cnv->self, ribi_type(route->at(max(1u,i)-1u), route->at(min(route->get_count()-1u,i+1u))), schiene_t::directional)))
+					|| sch1->can_reserve(cnv->self, ribi, schiene_t::directional)))
 				{
 					next_signal_index = last_stop_signal_index;
 					break;